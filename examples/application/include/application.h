@@ -7,6 +7,10 @@ void        Application_DestroyTexture(ImTextureID texture);
 int         Application_GetTextureWidth(ImTextureID texture);
 int         Application_GetTextureHeight(ImTextureID texture);
 
+// Moves vertices of following draw commands: position * scale + offset.
+// Valid only while draw data is rendered, from within ImDrawList callback.
+void        Application_SetDrawTransform(const ImVec2& offset, float scale);
+
 const char* Application_GetName();
 void Application_Initialize();
 void Application_Finalize();
@@ -166,6 +166,11 @@ int Application_GetTextureHeight(ImTextureID texture)
     return ImGui_GetTextureHeight(texture);
 }
 
+void Application_SetDrawTransform(const ImVec2& offset, float scale)
+{
+    ImGui_ImplDX11_SetTransform(offset, scale);
+}
+
 # if defined(_UNICODE)
 std::wstring widen(const std::string& str)
 {
@@ -112,6 +112,30 @@ static void ImGui_ImplDX11_SetupRenderState(ImDrawData* draw_data, ID3D11DeviceC
     ctx->RSSetState(g_pRasterizerState);
 }
 
+void ImGui_ImplDX11_SetTransform(const ImVec2& offset, float scale)
+{
+    // Same projection as in ImGui_ImplDX11_RenderDrawData(), premultiplied by scale and translation
+    ImDrawData* draw_data = ImGui::GetDrawData();
+    ID3D11DeviceContext* ctx = g_pd3dDeviceContext;
+    D3D11_MAPPED_SUBRESOURCE mapped_resource;
+    if (ctx->Map(g_pVertexConstantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_resource) != S_OK)
+        return;
+    VERTEX_CONSTANT_BUFFER* constant_buffer = (VERTEX_CONSTANT_BUFFER*)mapped_resource.pData;
+    float L = draw_data->DisplayPos.x;
+    float R = draw_data->DisplayPos.x + draw_data->DisplaySize.x;
+    float T = draw_data->DisplayPos.y;
+    float B = draw_data->DisplayPos.y + draw_data->DisplaySize.y;
+    float mvp[4][4] =
+    {
+        { 2.0f*scale/(R-L),                   0.0f,                               0.0f,   0.0f },
+        { 0.0f,                               2.0f*scale/(T-B),                   0.0f,   0.0f },
+        { 0.0f,                               0.0f,                               0.5f,   0.0f },
+        { (R+L)/(L-R) + 2.0f*offset.x/(R-L),  (T+B)/(B-T) + 2.0f*offset.y/(T-B),  0.5f,   1.0f },
+    };
+    memcpy(&constant_buffer->mvp, mvp, sizeof(mvp));
+    ctx->Unmap(g_pVertexConstantBuffer, 0);
+}
+
 // Render function
 // (this used to be set in io.RenderDrawListsFn and called by ImGui::Render(), but you can now call this directly from your main loop)
 void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
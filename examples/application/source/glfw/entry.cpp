@@ -103,6 +103,11 @@ int Application_GetTextureHeight(ImTextureID texture)
     return 0;
 }
 
+void Application_SetDrawTransform(const ImVec2& offset, float scale)
+{
+    ImGui_ImplGlfwGL3_SetTransform(offset, scale);
+}
+
 int main(int, char**)
 {
     // Setup window
@@ -139,6 +139,20 @@ void ImGui_ImplGlfwGL3_RenderDrawLists(ImDrawData* draw_data)
     glScissor(last_scissor_box[0], last_scissor_box[1], (GLsizei)last_scissor_box[2], (GLsizei)last_scissor_box[3]);
 }
 
+void ImGui_ImplGlfwGL3_SetTransform(const ImVec2& offset, float scale)
+{
+    // Same orthographic projection as in ImGui_ImplGlfwGL3_RenderDrawLists(), premultiplied by scale and translation
+    ImGuiIO& io = ImGui::GetIO();
+    const float ortho_projection[4][4] =
+    {
+        { 2.0f * scale/io.DisplaySize.x,          0.0f,                                    0.0f, 0.0f },
+        { 0.0f,                                   2.0f * scale/-io.DisplaySize.y,          0.0f, 0.0f },
+        { 0.0f,                                   0.0f,                                   -1.0f, 0.0f },
+        {-1.0f + 2.0f * offset.x/io.DisplaySize.x, 1.0f - 2.0f * offset.y/io.DisplaySize.y, 0.0f, 1.0f },
+    };
+    glUniformMatrix4fv(g_AttribLocationProjMtx, 1, GL_FALSE, &ortho_projection[0][0]);
+}
+
 void ImGui_ImplGlfwGL3_MouseButtonCallback(GLFWwindow*, int button, int action, int /*mods*/)
 {
     if (action == GLFW_PRESS && button >= 0 && button < 3)
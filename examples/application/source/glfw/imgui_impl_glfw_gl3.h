@@ -14,6 +14,9 @@ IMGUI_API bool        ImGui_ImplGlfwGL3_Init(GLFWwindow* window, bool install_ca
 IMGUI_API void        ImGui_ImplGlfwGL3_Shutdown();
 IMGUI_API void        ImGui_ImplGlfwGL3_NewFrame();
 
+// Transform vertices of following draw commands. Call from ImDrawList callback only.
+IMGUI_API void        ImGui_ImplGlfwGL3_SetTransform(const ImVec2& offset, float scale);
+
 // Use if you want to reset your rendering device without losing ImGui state.
 IMGUI_API void        ImGui_ImplGlfwGL3_InvalidateDeviceObjects();
 IMGUI_API bool        ImGui_ImplGlfwGL3_CreateDeviceObjects();
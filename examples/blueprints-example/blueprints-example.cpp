@@ -12,6 +12,8 @@
 #include <map>
 #include <algorithm>
 #include <utility>
+#include <new>
+#include <cstdlib>
 
 
 static inline ImRect ImGui_GetItemRect()
@@ -38,6 +40,132 @@ using ax::Widgets::IconType;
 
 static ed::EditorContext* m_Editor = nullptr;
 
+// Allocation check. Counts heap allocations made between ed::Begin() and ed::End(),
+// through ImGui allocator (draw lists) and global operator new (editor containers).
+// Once warmed up, idle frames and pan or drag frames with mouse held still must
+// not allocate. Moving mouse may show new content and grow buffers once.
+//
+// Replaces global operator new and delete for whole example, so it is compiled
+// only with BLUEPRINTS_CHECK_ALLOCATIONS defined.
+# if defined(BLUEPRINTS_CHECK_ALLOCATIONS)
+enum AllocationCheckFrame { AllocationCheck_Idle, AllocationCheck_Pan, AllocationCheck_Drag, AllocationCheck_Other, AllocationCheck_Count };
+
+static const int s_AllocationCheckWarmUp = 10;
+static bool      s_CheckAllocations      = false;
+static bool      s_CountAllocations      = false;
+static int       s_FrameAllocations      = 0;
+static int       s_AllocationCheckFrame  = AllocationCheck_Other;
+static int       s_AllocationCheckSteady = 0;
+static int       s_Allocations[AllocationCheck_Count] = {};
+
+static void* CountingMemAlloc(size_t size, void* userData)
+{
+    IM_UNUSED(userData);
+    if (s_CountAllocations)
+        ++s_FrameAllocations;
+    return malloc(size);
+}
+
+static void CountingMemFree(void* ptr, void* userData)
+{
+    IM_UNUSED(userData);
+    free(ptr);
+}
+
+void* operator new(size_t size)
+{
+    if (s_CountAllocations)
+        ++s_FrameAllocations;
+    if (auto ptr = malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t size) noexcept
+{
+    IM_UNUSED(size);
+    free(ptr);
+}
+
+// ImGui allocator is installed before main(), so context is created with it
+// and every block is released by the same allocator which made it.
+static struct AllocationCheckInstaller
+{
+    AllocationCheckInstaller()
+    {
+        ImGui::SetAllocatorFunctions(CountingMemAlloc, CountingMemFree);
+    }
+} s_AllocationCheckInstaller;
+
+static void BeginAllocationCheck()
+{
+    s_FrameAllocations = 0;
+    s_CountAllocations = s_CheckAllocations;
+}
+
+static void EndAllocationCheck()
+{
+    s_CountAllocations = false;
+    if (!s_CheckAllocations)
+        return;
+
+    auto& io = ImGui::GetIO();
+
+    bool anyKeyDown = false;
+    for (auto keyDown : io.KeysDown)
+        anyKeyDown |= keyDown;
+
+    auto frame = AllocationCheck_Other;
+    if (io.MouseDown[1])
+        frame = AllocationCheck_Pan;
+    else if (io.MouseDown[0])
+        frame = AllocationCheck_Drag;
+    else if (!anyKeyDown && !io.MouseDown[2])
+        frame = AllocationCheck_Idle;
+
+    const auto isStill = io.MouseDelta.x == 0.0f && io.MouseDelta.y == 0.0f && io.MouseWheel == 0.0f;
+    if (frame == s_AllocationCheckFrame && isStill)
+        ++s_AllocationCheckSteady;
+    else
+        s_AllocationCheckSteady = 0;
+    s_AllocationCheckFrame = frame;
+
+    s_Allocations[frame] += s_FrameAllocations;
+
+    IM_ASSERT((frame == AllocationCheck_Other || s_AllocationCheckSteady < s_AllocationCheckWarmUp || s_FrameAllocations == 0) && "Editor allocated memory on a steady frame.");
+}
+
+static void ShowAllocationCheck(float paneWidth)
+{
+    ImGui::GetWindowDrawList()->AddRectFilled(
+        ImGui::GetCursorScreenPos(),
+        ImGui::GetCursorScreenPos() + ImVec2(paneWidth, ImGui::GetTextLineHeight()),
+        ImColor(ImGui::GetStyle().Colors[ImGuiCol_HeaderActive]), ImGui::GetTextLineHeight() * 0.25f);
+    ImGui::Spacing(); ImGui::SameLine();
+    ImGui::TextUnformatted("Diagnostics");
+    ImGui::Indent();
+    if (ImGui::Checkbox("Check Allocations", &s_CheckAllocations))
+        memset(s_Allocations, 0, sizeof(s_Allocations));
+    if (s_CheckAllocations)
+    {
+        ImGui::Text("Last Frame: %d", s_FrameAllocations);
+        ImGui::Text("Idle: %d Pan: %d Drag: %d Other: %d",
+            s_Allocations[AllocationCheck_Idle], s_Allocations[AllocationCheck_Pan],
+            s_Allocations[AllocationCheck_Drag], s_Allocations[AllocationCheck_Other]);
+    }
+    ImGui::Unindent();
+}
+# else
+static void BeginAllocationCheck() {}
+static void EndAllocationCheck() {}
+static void ShowAllocationCheck(float) {}
+# endif
+
 //extern "C" __declspec(dllimport) short __stdcall GetAsyncKeyState(int vkey);
 //extern "C" bool Debug_KeyPress(int vkey)
 //{
@@ -674,6 +802,8 @@ void ShowStyleEditor(bool* show = nullptr)
     //float   PinArrowWidth;
     ImGui::DragFloat("Group Rounding", &editorStyle.GroupRounding, 0.1f, 0.0f, 40.0f);
     ImGui::DragFloat("Group Border Width", &editorStyle.GroupBorderWidth, 0.1f, 0.0f, 15.0f);
+    ImGui::DragFloat("LOD Reduced Scale", &editorStyle.LodReducedScale, 0.01f, 0.0f, 2.0f);
+    ImGui::DragFloat("LOD Coarse Scale", &editorStyle.LodCoarseScale, 0.01f, 0.0f, 2.0f);
 
     ImGui::Separator();
 
@@ -877,6 +1007,8 @@ void ShowLeftPane(float paneWidth)
     if (ed::HasSelectionChanged())
         ++changeCount;
 
+    ShowAllocationCheck(paneWidth);
+
     ImGui::EndChild();
 }
 
@@ -917,6 +1049,8 @@ void Application_Frame()
 
     ImGui::SameLine(0.0f, 12.0f);
 
+    BeginAllocationCheck();
+
     ed::Begin("Node editor");
     {
         auto cursorTopLeft = ImGui::GetCursorScreenPos();
@@ -1727,6 +1861,7 @@ void Application_Frame()
 
     ed::End();
 
+    EndAllocationCheck();
 
     //ImGui::ShowTestWindow();
     //ImGui::ShowMetricsWindow();
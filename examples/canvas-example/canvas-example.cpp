@@ -3,6 +3,7 @@
 # include <imgui_internal.h>
 # include <imgui_canvas.h>
 # include <application.h>
+# include <chrono>
 
 static void DrawScale(const ImVec2& from, const ImVec2& to, float majorUnit, float minorUnit, float labelAlignment, float sign = 1.0f)
 {
@@ -58,6 +59,12 @@ static bool Splitter(bool split_vertically, float thickness, float* size1, float
     return SplitterBehavior(bb, id, split_vertically ? ImGuiAxis_X : ImGuiAxis_Y, size1, size2, min_size1, min_size2, 0.0f);
 }
 
+static void CanvasTransformCallback(const ImDrawList*, const ImDrawCmd* cmd)
+{
+    auto transform = reinterpret_cast<const ImGuiEx::CanvasTransform*>(cmd->UserCallbackData);
+    Application_SetDrawTransform(transform->Offset, transform->Scale);
+}
+
 const char* Application_GetName()
 {
     return "Canvas";
@@ -107,6 +114,9 @@ void Application_Frame()
     static ImVec2 drawStartPoint;
     static bool isDragging = false;
     static ImRect panelRect;
+    static bool gpuTransform = false;
+    static int stressRects = 0;
+    static float endTime = 0.0f;
 
     Splitter(true, s_SplitterSize, &s_LeftPaneSize, &s_RightPaneSize, 100.0f, 100.0f);
 
@@ -176,6 +186,22 @@ void Application_Frame()
     ImGui::Text("\tH: %.2f", panelRect.GetHeight()); ImGui::NextColumn();
     ImGui::EndColumns();
 
+    ImGui::Separator();
+
+    if (ImGui::Checkbox("GPU Transform", &gpuTransform))
+        canvas.SetTransformCallback(gpuTransform ? CanvasTransformCallback : nullptr);
+
+    ImGui::TextUnformatted("Stress Rects:");
+    ImGui::Indent();
+    ImGui::PushItemWidth(-ImGui::GetStyle().IndentSpacing);
+    // Without large mesh support 16-bit indices limit draw list to 64k vertices.
+    auto maxStressRects = (io.BackendFlags & ImGuiBackendFlags_RendererHasVtxOffset) ? 2500000 : 16000;
+    ImGui::DragInt("##stressrects", &stressRects, 100.0f, 0, maxStressRects);
+    stressRects = ImClamp(stressRects, 0, maxStressRects);
+    ImGui::PopItemWidth();
+    ImGui::Unindent();
+    ImGui::Text("End: %.3f ms (%d vertices)", endTime, stressRects * 4);
+
     ImGui::EndChild();
 
     ImGui::SameLine(0.0f, s_SplitterSize);
@@ -219,7 +245,17 @@ void Application_Frame()
         panelRect.Min = ImGui::GetItemRectMin();
         panelRect.Max = ImGui::GetItemRectMax();
 
+        // Every rect is 4 vertices, moved to screen space by canvas.End() unless GPU transform is on.
+        auto drawList = ImGui::GetWindowDrawList();
+        for (int i = 0; i < stressRects; ++i)
+        {
+            auto p = ImVec2(static_cast<float>(i % 500) * 4.0f, 200.0f + static_cast<float>(i / 500) * 4.0f);
+            drawList->AddRectFilled(p, p + ImVec2(3.0f, 3.0f), IM_COL32(255, 128, 0, 255));
+        }
+
+        auto endStart = std::chrono::high_resolution_clock::now();
         canvas.End();
+        endTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - endStart).count();
     }
 
 
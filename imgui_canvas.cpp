@@ -2,6 +2,27 @@
 # include "imgui_canvas.h"
 # include <type_traits>
 
+# if !defined(IMGUI_EX_CANVAS_NO_SIMD)
+#   if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#     define IMGUI_EX_CANVAS_SSE2 1
+#     include <emmintrin.h>
+#   elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#     define IMGUI_EX_CANVAS_NEON 1
+#     include <arm_neon.h>
+#   endif
+# endif
+
+// Keep multiply and add of the vertex transform rounded separately. Compilers
+// are free to fuse them into FMA (GCC does by default, on aarch64 and with
+// -mfma), which would make SIMD and scalar results depend on code generation.
+# if defined(__clang__)
+#   pragma clang fp contract(off)
+# elif defined(__GNUC__)
+#   pragma GCC optimize ("fp-contract=off")
+# elif defined(_MSC_VER)
+#   pragma fp_contract(off)
+# endif
+
 // https://stackoverflow.com/a/36079786
 # define DECLARE_HAS_MEMBER(__trait_name__, __member_name__)                         \
                                                                                      \
@@ -66,6 +87,81 @@ struct VtxCurrentOffsetRef
     }
 };
 
+// Moves vertex positions to screen space: pos * scale + offset.
+//
+// Only position of ImDrawVert is touched. SIMD kernels load positions
+// of two vertices into one register, uv and col are never read.
+// Define IMGUI_EX_CANVAS_NO_SIMD to always use scalar code.
+struct VertexTransform
+{
+    static void Scalar(ImDrawVert* vertex, ImDrawVert* vertexEnd, const ImVec2& offset, float scale)
+    {
+        // If canvas view is not scaled take a faster path.
+        if (scale != 1.0f)
+        {
+            while (vertex < vertexEnd)
+            {
+                vertex->pos.x = vertex->pos.x * scale + offset.x;
+                vertex->pos.y = vertex->pos.y * scale + offset.y;
+                ++vertex;
+            }
+        }
+        else
+        {
+            while (vertex < vertexEnd)
+            {
+                vertex->pos.x = vertex->pos.x + offset.x;
+                vertex->pos.y = vertex->pos.y + offset.y;
+                ++vertex;
+            }
+        }
+    }
+
+# if IMGUI_EX_CANVAS_SSE2
+    static void SIMD(ImDrawVert* vertex, ImDrawVert* vertexEnd, const ImVec2& offset, float scale)
+    {
+        const auto scales  = _mm_set1_ps(scale);
+        const auto offsets = _mm_setr_ps(offset.x, offset.y, offset.x, offset.y);
+
+        auto blockEnd = vertex + (vertexEnd - vertex) / 4 * 4;
+        for (; vertex < blockEnd; vertex += 4)
+        {
+            auto p01 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&vertex[0].pos)), reinterpret_cast<const __m64*>(&vertex[1].pos));
+            auto p23 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&vertex[2].pos)), reinterpret_cast<const __m64*>(&vertex[3].pos));
+            p01 = _mm_add_ps(_mm_mul_ps(p01, scales), offsets);
+            p23 = _mm_add_ps(_mm_mul_ps(p23, scales), offsets);
+            _mm_storel_pi(reinterpret_cast<__m64*>(&vertex[0].pos), p01);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(&vertex[1].pos), p01);
+            _mm_storel_pi(reinterpret_cast<__m64*>(&vertex[2].pos), p23);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(&vertex[3].pos), p23);
+        }
+
+        Scalar(vertex, vertexEnd, offset, scale);
+    }
+# elif IMGUI_EX_CANVAS_NEON
+    static void SIMD(ImDrawVert* vertex, ImDrawVert* vertexEnd, const ImVec2& offset, float scale)
+    {
+        const auto scales  = vdupq_n_f32(scale);
+        const auto offsets = vcombine_f32(vld1_f32(&offset.x), vld1_f32(&offset.x));
+
+        auto blockEnd = vertex + (vertexEnd - vertex) / 4 * 4;
+        for (; vertex < blockEnd; vertex += 4)
+        {
+            auto p01 = vcombine_f32(vld1_f32(&vertex[0].pos.x), vld1_f32(&vertex[1].pos.x));
+            auto p23 = vcombine_f32(vld1_f32(&vertex[2].pos.x), vld1_f32(&vertex[3].pos.x));
+            p01 = vaddq_f32(vmulq_f32(p01, scales), offsets);
+            p23 = vaddq_f32(vmulq_f32(p23, scales), offsets);
+            vst1_f32(&vertex[0].pos.x, vget_low_f32(p01));
+            vst1_f32(&vertex[1].pos.x, vget_high_f32(p01));
+            vst1_f32(&vertex[2].pos.x, vget_low_f32(p23));
+            vst1_f32(&vertex[3].pos.x, vget_high_f32(p23));
+        }
+
+        Scalar(vertex, vertexEnd, offset, scale);
+    }
+# endif
+};
+
 } // namespace ImCanvasDetails
 
 // Returns a reference to _FringeScale extension to ImDrawList
@@ -83,8 +179,47 @@ static inline unsigned int& ImVtxOffsetRef(ImDrawList* drawList)
     return VtxCurrentOffsetRef::Get<ImDrawList>(drawList);
 }
 
+static inline void ImTransformVertices(ImDrawVert* vertex, ImDrawVert* vertexEnd, const ImVec2& offset, float scale)
+{
+    using namespace ImCanvasDetails;
+# if IMGUI_EX_CANVAS_SSE2 || IMGUI_EX_CANVAS_NEON
+    VertexTransform::SIMD(vertex, vertexEnd, offset, scale);
+# else
+    VertexTransform::Scalar(vertex, vertexEnd, offset, scale);
+# endif
+}
+
+static inline void ImTransformClipRects(ImDrawCmd* command, ImDrawCmd* commandEnd, const ImVec2& offset, float scale)
+{
+# if IMGUI_EX_CANVAS_SSE2
+    const auto scales  = _mm_set1_ps(scale);
+    const auto offsets = _mm_setr_ps(offset.x, offset.y, offset.x, offset.y);
+    for (; command < commandEnd; ++command)
+        _mm_storeu_ps(&command->ClipRect.x, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&command->ClipRect.x), scales), offsets));
+# elif IMGUI_EX_CANVAS_NEON
+    const auto scales  = vdupq_n_f32(scale);
+    const auto offsets = vcombine_f32(vld1_f32(&offset.x), vld1_f32(&offset.x));
+    for (; command < commandEnd; ++command)
+        vst1q_f32(&command->ClipRect.x, vaddq_f32(vmulq_f32(vld1q_f32(&command->ClipRect.x), scales), offsets));
+# else
+    for (; command < commandEnd; ++command)
+    {
+        command->ClipRect.x = command->ClipRect.x * scale + offset.x;
+        command->ClipRect.y = command->ClipRect.y * scale + offset.y;
+        command->ClipRect.z = command->ClipRect.z * scale + offset.x;
+        command->ClipRect.w = command->ClipRect.w * scale + offset.y;
+    }
+# endif
+}
+
 static inline ImVec2 ImSelectPositive(const ImVec2& lhs, const ImVec2& rhs) { return ImVec2(lhs.x > 0.0f ? lhs.x : rhs.x, lhs.y > 0.0f ? lhs.y : rhs.y); }
 
+ImGuiEx::Canvas::~Canvas()
+{
+    for (auto transform : m_Transforms)
+        IM_DELETE(transform);
+}
+
 bool ImGuiEx::Canvas::Begin(const char* id, const ImVec2& size)
 {
     return Begin(ImGui::GetID(id), size);
@@ -114,9 +249,7 @@ bool ImGuiEx::Canvas::Begin(ImGuiID id, const ImVec2& size)
 
     ImGui::SetCursorScreenPos(ImVec2(0.0f, 0.0f));
 
-# if IMGUI_EX_CANVAS_DEFERED()
-    m_Ranges.resize(0);
-# endif
+    m_TransformCount = 0;
 
     SaveInputState();
     SaveViewportState();
@@ -397,12 +530,9 @@ void ImGuiEx::Canvas::EnterLocalSpace()
     if ((!m_DrawList->CmdBuffer.empty() && m_DrawList->CmdBuffer.back().ElemCount > 0) || m_DrawList->_Splitter._Count > 1)
         m_DrawList->AddDrawCmd();
 
-# if IMGUI_EX_CANVAS_DEFERED()
-    m_Ranges.resize(m_Ranges.Size + 1);
-    m_CurrentRange = &m_Ranges.back();
-    m_CurrentRange->BeginComandIndex = ImMax(m_DrawList->CmdBuffer.Size - 1, 0);
-    m_CurrentRange->BeginVertexIndex = m_DrawList->_VtxCurrentIdx + ImVtxOffsetRef(m_DrawList);
-# endif
+    // Let renderer move vertices to the screen.
+    AddViewTransformCallback();
+
     m_DrawListCommadBufferSize       = ImMax(m_DrawList->CmdBuffer.Size - 1, 0);
     m_DrawListStartVertexIndex       = m_DrawList->_VtxCurrentIdx + ImVtxOffsetRef(m_DrawList);
 
@@ -445,62 +575,22 @@ void ImGuiEx::Canvas::LeaveLocalSpace()
 {
     IM_ASSERT(m_DrawList->_Splitter._Current == m_ExpectedChannel);
 
-# if IMGUI_EX_CANVAS_DEFERED()
-    IM_ASSERT(m_CurrentRange != nullptr);
-
-    m_CurrentRange->EndVertexIndex  = m_DrawList->_VtxCurrentIdx + ImVtxOffsetRef(m_DrawList);
-    m_CurrentRange->EndCommandIndex = m_DrawList->CmdBuffer.size();
-    if (m_CurrentRange->BeginVertexIndex == m_CurrentRange->EndVertexIndex)
-    {
-        // Drop empty range
-        m_Ranges.resize(m_Ranges.Size - 1);
-    }
-    m_CurrentRange = nullptr;
-# endif
-
     // Move vertices to screen space.
     auto vertex    = m_DrawList->VtxBuffer.Data + m_DrawListStartVertexIndex;
     auto vertexEnd = m_DrawList->VtxBuffer.Data + m_DrawList->_VtxCurrentIdx + ImVtxOffsetRef(m_DrawList);
 
-    // If canvas view is not scaled take a faster path.
-    if (m_View.Scale != 1.0f)
+    // Renderer does that, restore identity transform after canvas content.
+    if (m_TransformCallback)
     {
-        while (vertex < vertexEnd)
-        {
-            vertex->pos.x = vertex->pos.x * m_View.Scale + m_ViewTransformPosition.x;
-            vertex->pos.y = vertex->pos.y * m_View.Scale + m_ViewTransformPosition.y;
-            ++vertex;
-        }
+        vertexEnd = vertex;
 
-        // Move clip rectangles to screen space.
-        for (int i = m_DrawListCommadBufferSize; i < m_DrawList->CmdBuffer.size(); ++i)
-        {
-            auto& command = m_DrawList->CmdBuffer[i];
-            command.ClipRect.x = command.ClipRect.x * m_View.Scale + m_ViewTransformPosition.x;
-            command.ClipRect.y = command.ClipRect.y * m_View.Scale + m_ViewTransformPosition.y;
-            command.ClipRect.z = command.ClipRect.z * m_View.Scale + m_ViewTransformPosition.x;
-            command.ClipRect.w = command.ClipRect.w * m_View.Scale + m_ViewTransformPosition.y;
-        }
+        AddScreenTransformCallback();
     }
-    else
-    {
-        while (vertex < vertexEnd)
-        {
-            vertex->pos.x = vertex->pos.x + m_ViewTransformPosition.x;
-            vertex->pos.y = vertex->pos.y + m_ViewTransformPosition.y;
-            ++vertex;
-        }
 
-        // Move clip rectangles to screen space.
-        for (int i = m_DrawListCommadBufferSize; i < m_DrawList->CmdBuffer.size(); ++i)
-        {
-            auto& command = m_DrawList->CmdBuffer[i];
-            command.ClipRect.x = command.ClipRect.x + m_ViewTransformPosition.x;
-            command.ClipRect.y = command.ClipRect.y + m_ViewTransformPosition.y;
-            command.ClipRect.z = command.ClipRect.z + m_ViewTransformPosition.x;
-            command.ClipRect.w = command.ClipRect.w + m_ViewTransformPosition.y;
-        }
-    }
+    ImTransformVertices(vertex, vertexEnd, m_ViewTransformPosition, m_View.Scale);
+
+    // Move clip rectangles to screen space.
+    ImTransformClipRects(m_DrawList->CmdBuffer.Data + m_DrawListCommadBufferSize, m_DrawList->CmdBuffer.Data + m_DrawList->CmdBuffer.Size, m_ViewTransformPosition, m_View.Scale);
 
     auto& fringeScale = ImFringeScaleRef(m_DrawList);
     fringeScale = m_LastFringeScale;
@@ -511,3 +601,30 @@ void ImGuiEx::Canvas::LeaveLocalSpace()
     RestoreInputState();
     RestoreViewportState();
 }
+
+void ImGuiEx::Canvas::AddScreenTransformCallback()
+{
+    if (m_TransformCallback)
+        m_DrawList->AddCallback(m_TransformCallback, AllocateTransform());
+}
+
+void ImGuiEx::Canvas::AddViewTransformCallback()
+{
+    if (!m_TransformCallback)
+        return;
+
+    auto transform = AllocateTransform();
+    transform->Offset = m_ViewTransformPosition;
+    transform->Scale  = m_View.Scale;
+    m_DrawList->AddCallback(m_TransformCallback, transform);
+}
+
+ImGuiEx::CanvasTransform* ImGuiEx::Canvas::AllocateTransform()
+{
+    if (m_TransformCount == m_Transforms.Size)
+        m_Transforms.push_back(IM_NEW(CanvasTransform)());
+
+    auto transform = m_Transforms[m_TransformCount++];
+    *transform = CanvasTransform();
+    return transform;
+}
@@ -32,6 +32,10 @@
 // Sometimes in more elaborate scenarios you want to move out canvas virtual space,
 // do something and came back. You can do that with SuspendCanvas() and ResumeCanvas().
 //
+// By default vertices are moved from virtual space to the screen on CPU. If renderer
+// can apply transformation on its own, canvas can leave vertices untouched and emit
+// draw callbacks instead. See SetTransformCallback().
+//
 // Note:
 //     It is not valid to call canvas API outside of BeginCanvas() / EndCanvas() scope.
 //
@@ -71,6 +75,16 @@ struct CanvasView
     }
 };
 
+// Transformation from canvas plane to the screen passed to renderer
+// in draw callback, see Canvas::SetTransformCallback().
+//
+//     screen position = local position * Scale + Offset
+struct CanvasTransform
+{
+    ImVec2 Offset;
+    float  Scale = 1.0f;
+};
+
 // Canvas widget represent view over infinite plane.
 //
 // It acts like a child window without scroll bars with
@@ -90,6 +104,11 @@ struct CanvasView
 //     call canvas functions from same channel.
 struct Canvas
 {
+    Canvas() = default;
+    Canvas(const Canvas&) = delete;
+    Canvas& operator=(const Canvas&) = delete;
+    ~Canvas();
+
     // Begins drawing content of canvas plane.
     //
     // When false is returned that mean canvas is not visible to the
@@ -192,19 +211,38 @@ struct Canvas
     // See: Suspend()/Resume()
     bool IsSuspended() const { return m_SuspendCounter > 0; }
 
-private:
-# define IMGUI_EX_CANVAS_DEFERED() 0
+    // Sets callback which applies view transformation in renderer.
+    //
+    // When callback is set, vertices drawn on canvas plane are not moved
+    // to the screen on CPU. Instead draw list receives callback command
+    // at the start and at the end of every canvas content range. Its
+    // UserCallbackData points to CanvasTransform which renderer should
+    // apply to following vertices. Transform at the end of range is
+    // an identity. Clip rectangles are always moved to the screen on CPU.
+    //
+    // Pass nullptr to transform vertices on CPU (default).
+    //
+    // Note:
+    //     Content drawn in other channels is transformed according
+    //     to callbacks preceding it after channels are merged. Keep
+    //     channel splitter contained inside canvas.
+    void SetTransformCallback(ImDrawCallback callback) { m_TransformCallback = callback; }
+    ImDrawCallback TransformCallback() const { return m_TransformCallback; }
 
-# if IMGUI_EX_CANVAS_DEFERED()
-    struct Range
-    {
-        int BeginVertexIndex = 0;
-        int EndVertexIndex   = 0;
-        int BeginComandIndex = 0;
-        int EndCommandIndex  = 0;
-    };
-# endif
+    // Adds transform callback to current channel of the draw list.
+    //
+    // Suspend() and Resume() add their callbacks to the channel canvas
+    // was begun in. Content drawn in screen space into another channel
+    // while canvas is suspended gets transform of whatever precedes it
+    // after channels are merged. Enclose such content with
+    // AddScreenTransformCallback() and AddViewTransformCallback() in
+    // its own channel.
+    //
+    // Does nothing when no transform callback is set.
+    void AddScreenTransformCallback();
+    void AddViewTransformCallback();
 
+private:
     void UpdateViewTransformPosition();
 
     void SaveInputState();
@@ -216,6 +254,8 @@ private:
     void EnterLocalSpace();
     void LeaveLocalSpace();
 
+    CanvasTransform* AllocateTransform();
+
     bool m_InBeginEnd = false;
 
     ImVec2 m_WidgetPosition;
@@ -225,10 +265,12 @@ private:
     ImDrawList* m_DrawList = nullptr;
     int m_ExpectedChannel = 0;
 
-# if IMGUI_EX_CANVAS_DEFERED()
-    ImVector<Range> m_Ranges;
-    Range* m_CurrentRange = nullptr;
-# endif
+    ImDrawCallback m_TransformCallback = nullptr;
+
+    // Transforms are referenced by draw commands until frame is rendered,
+    // so storage is reused only after next Begin().
+    ImVector<CanvasTransform*> m_Transforms;
+    int m_TransformCount = 0;
 
     int m_DrawListCommadBufferSize = 0;
     int m_DrawListStartVertexIndex = 0;
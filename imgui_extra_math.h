@@ -48,6 +48,7 @@ inline ImVec2 ImRect_ClosestPoint(const ImRect& rect, const ImVec2& p, bool snap
 inline ImVec2 ImRect_ClosestPoint(const ImRect& rect, const ImRect& b);
 inline ImLine ImRect_ClosestLine(const ImRect& rect_a, const ImRect& rect_b);
 inline ImLine ImRect_ClosestLine(const ImRect& rect_a, const ImRect& rect_b, float radius_a, float radius_b);
+inline bool   ImRect_OverlapsLine(const ImRect& rect, const ImVec2& a, const ImVec2& b);
 
 
 
@@ -182,6 +182,40 @@ inline ImLine ImRect_ClosestLine(const ImRect& rect_a, const ImRect& rect_b, flo
     return line;
 }
 
+inline bool ImRect_OverlapsLine(const ImRect& rect, const ImVec2& a, const ImVec2& b)
+{
+    // Liang-Barsky clipping, segment overlaps if any part of it survives
+    const auto d = b - a;
+
+    float t0 = 0.0f, t1 = 1.0f;
+    auto clip = [&t0, &t1](float p, float q)
+    {
+        if (p == 0.0f)
+            return q >= 0.0f;
+
+        const auto r = q / p;
+        if (p < 0.0f)
+        {
+            if (r > t1)
+                return false;
+            if (r > t0)
+                t0 = r;
+        }
+        else
+        {
+            if (r < t0)
+                return false;
+            if (r < t1)
+                t1 = r;
+        }
+
+        return true;
+    };
+
+    return clip(-d.x, a.x - rect.Min.x) && clip(d.x, rect.Max.x - a.x)
+        && clip(-d.y, a.y - rect.Min.y) && clip(d.y, rect.Max.y - a.y);
+}
+
 
 //------------------------------------------------------------------------------
 # endif // __IMGUI_EXTRA_MATH_INL__
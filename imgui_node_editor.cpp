@@ -108,6 +108,12 @@ static const int c_NodeContentChannel        = 4;
 
 static const float c_GroupSelectThickness       = 6.0f;  // canvas pixels
 static const float c_LinkSelectThickness        = 5.0f;  // canvas pixels
+static const float c_LinkHitTestTolerance       = 0.1f;  // canvas pixels, max distance of hit test polyline from curve
+static const int   c_FrameStatsHistorySize      = 120;   // frames
+static const int   c_MaxBatchOverlapsPerNode    = 16;    // overlapping pairs, above that every node gets own batch
+static const float c_MaxBatchCellsPerAxis       = 16.0f; // cells spanned by the largest node while batching
+static const float c_GridLevelRatio             = 10.0f; // spacing of next grid level
+static const float c_GridFadeOutSpacing         = 0.25f; // fraction of grid size, on screen spacing at which grid level disappears
 static const float c_NavigationZoomMargin       = 0.1f;  // percentage of visible bounds
 static const float c_MouseZoomDuration          = 0.15f; // seconds
 static const float c_SelectionFadeOutDuration   = 0.15f; // seconds
@@ -226,6 +232,81 @@ static void ImDrawList_SwapChannels(ImDrawList* drawList, int left, int right)
 	ImDrawListSplitter_SwapChannels(&drawList->_Splitter, left, right);
 }
 
+static bool ImDrawCmd_CanMerge(const ImDrawCmd& lhs, const ImDrawCmd& rhs)
+{
+    return memcmp(&lhs.ClipRect, &rhs.ClipRect, sizeof(lhs.ClipRect)) == 0
+        && lhs.TextureId == rhs.TextureId
+        && lhs.VtxOffset == rhs.VtxOffset
+        && !lhs.UserCallback && !rhs.UserCallback;
+}
+
+// Channel without geometry and callbacks draws nothing.
+static bool ImDrawListSplitter_IsChannelEmpty(const ImDrawListSplitter* splitter, int index)
+{
+    auto& channel = splitter->_Channels[index];
+    return channel._IdxBuffer.Size == 0 && std::none_of(channel._CmdBuffer.begin(), channel._CmdBuffer.end(), [](const ImDrawCmd& cmd) { return cmd.UserCallback != nullptr; });
+}
+
+// Moves content of source channel to the end of target channel, source is left empty.
+// Commands at the seam are merged if compatible. Channels without geometry are ignored.
+static void ImDrawListSplitter_AppendChannel(ImDrawListSplitter* splitter, int source, int target)
+{
+    IM_ASSERT(source != splitter->_Current && target != splitter->_Current);
+
+    if (ImDrawListSplitter_IsChannelEmpty(splitter, source))
+        return;
+
+    auto& sourceChannel = splitter->_Channels[source];
+    auto& targetChannel = splitter->_Channels[target];
+
+    auto& targetCmdBuffer = targetChannel._CmdBuffer;
+    if (!targetCmdBuffer.empty() && targetCmdBuffer.back().ElemCount == 0 && !targetCmdBuffer.back().UserCallback)
+        targetCmdBuffer.pop_back();
+
+    if (targetCmdBuffer.empty() && targetChannel._IdxBuffer.empty())
+    {
+        targetCmdBuffer.swap(sourceChannel._CmdBuffer);
+        targetChannel._IdxBuffer.swap(sourceChannel._IdxBuffer);
+        return;
+    }
+
+    for (auto& cmd : sourceChannel._CmdBuffer)
+    {
+        if (cmd.ElemCount == 0 && !cmd.UserCallback)
+            continue;
+
+        if (!targetCmdBuffer.empty() && ImDrawCmd_CanMerge(targetCmdBuffer.back(), cmd))
+            targetCmdBuffer.back().ElemCount += cmd.ElemCount;
+        else
+            targetCmdBuffer.push_back(cmd);
+    }
+
+    auto& targetIdxBuffer = targetChannel._IdxBuffer;
+    const auto idxCount = targetIdxBuffer.Size;
+    targetIdxBuffer.resize(idxCount + sourceChannel._IdxBuffer.Size);
+    memcpy(targetIdxBuffer.Data + idxCount, sourceChannel._IdxBuffer.Data, sourceChannel._IdxBuffer.Size * sizeof(ImDrawIdx));
+
+    sourceChannel._CmdBuffer.resize(0);
+    sourceChannel._IdxBuffer.resize(0);
+}
+
+static int ImDrawList_CountDrawCalls(ImDrawList* drawList)
+{
+    auto countChannel = [](const ImVector<ImDrawCmd>& cmdBuffer)
+    {
+        return static_cast<int>(std::count_if(cmdBuffer.begin(), cmdBuffer.end(), [](const ImDrawCmd& cmd) { return cmd.ElemCount > 0 || cmd.UserCallback; }));
+    };
+
+    const auto& splitter = drawList->_Splitter;
+
+    int result = countChannel(drawList->CmdBuffer);
+    for (int i = 0; i < splitter._Count; ++i)
+        if (i != splitter._Current)
+            result += countChannel(splitter._Channels[i]._CmdBuffer);
+
+    return result;
+}
+
 static void ImDrawList_SwapSplitter(ImDrawList* drawList, ImDrawListSplitter& splitter)
 {
     auto& currentSplitter = drawList->_Splitter;
@@ -539,16 +620,19 @@ void ed::Pin::Draw(ImDrawList* drawList, DrawFlags flags)
 {
     if (flags & Hovered)
     {
-        drawList->ChannelsSetCurrent(m_Node->m_Channel + c_NodePinChannel);
+        if (Editor->GetLevelOfDetail() != LevelOfDetail::Coarse)
+        {
+            drawList->ChannelsSetCurrent(m_Node->m_Channel + c_NodePinChannel);
 
-        drawList->AddRectFilled(m_Bounds.Min, m_Bounds.Max,
-            m_Color, m_Rounding, m_Corners);
+            drawList->AddRectFilled(m_Bounds.Min, m_Bounds.Max,
+                m_Color, m_Rounding, m_Corners);
 
-        if (m_BorderWidth > 0.0f)
-        {
-            FringeScaleScope fringe(1.0f);
-            drawList->AddRect(m_Bounds.Min, m_Bounds.Max,
-                m_BorderColor, m_Rounding, m_Corners, m_BorderWidth);
+            if (m_BorderWidth > 0.0f)
+            {
+                FringeScaleScope fringe(1.0f);
+                drawList->AddRect(m_Bounds.Min, m_Bounds.Max,
+                    m_BorderColor, m_Rounding, m_Corners, m_BorderWidth);
+            }
         }
 
         if (!Editor->IsSelected(m_Node))
@@ -581,6 +665,12 @@ bool ed::Node::AcceptDrag()
 }
 
 void ed::Node::UpdateDrag(const ImVec2& offset)
+{
+    MoveToDragOffset(offset);
+    Editor->UpdateNodeIndex(this);
+}
+
+void ed::Node::MoveToDragOffset(const ImVec2& offset)
 {
     auto size = m_Bounds.GetSize();
     m_Bounds.Min = ImFloor(m_DragStart + offset);
@@ -596,28 +686,33 @@ void ed::Node::Draw(ImDrawList* drawList, DrawFlags flags)
 {
     if (flags == Detail::Object::None)
     {
+        // Rounding is not visible on small nodes, tiny nodes are drawn as flat rectangles.
+        const auto lod      = Editor->GetLevelOfDetail();
+        const bool isCoarse = lod == LevelOfDetail::Coarse;
+        const bool isRound  = lod == LevelOfDetail::Full;
+
         drawList->ChannelsSetCurrent(m_Channel + c_NodeBackgroundChannel);
 
         drawList->AddRectFilled(
             m_Bounds.Min,
             m_Bounds.Max,
-            m_Color, m_Rounding);
+            m_Color, isRound ? m_Rounding : 0.0f);
 
         if (IsGroup(this))
         {
             drawList->AddRectFilled(
                 m_GroupBounds.Min,
                 m_GroupBounds.Max,
-                m_GroupColor, m_GroupRounding);
+                m_GroupColor, isRound ? m_GroupRounding : 0.0f);
 
-            if (m_GroupBorderWidth > 0.0f)
+            if (m_GroupBorderWidth > 0.0f && !isCoarse)
             {
                 FringeScaleScope fringe(1.0f);
 
                 drawList->AddRect(
                     m_GroupBounds.Min,
                     m_GroupBounds.Max,
-                    m_GroupBorderColor, m_GroupRounding, 15, m_GroupBorderWidth);
+                    m_GroupBorderColor, isRound ? m_GroupRounding : 0.0f, 15, m_GroupBorderWidth);
             }
         }
 
@@ -641,7 +736,8 @@ void ed::Node::Draw(ImDrawList* drawList, DrawFlags flags)
         drawRect(GetRegionBounds(NodeRegion::Header), IM_COL32(0, 255, 255, 64));
 # endif
 
-        DrawBorder(drawList, m_BorderColor, m_BorderWidth);
+        if (!isCoarse)
+            DrawBorder(drawList, m_BorderColor, m_BorderWidth);
     }
     else if (flags & Selected)
     {
@@ -667,8 +763,10 @@ void ed::Node::DrawBorder(ImDrawList* drawList, ImU32 color, float thickness)
 {
     if (thickness > 0.0f)
     {
+        const auto rounding = Editor->GetLevelOfDetail() == LevelOfDetail::Full ? m_Rounding : 0.0f;
+
         drawList->AddRect(m_Bounds.Min, m_Bounds.Max,
-            color, m_Rounding, 15, thickness);
+            color, rounding, 15, thickness);
     }
 }
 
@@ -680,11 +778,26 @@ void ed::Node::GetGroupedNodes(std::vector<Node*>& result, bool append)
     if (!IsGroup(this))
         return;
 
-    const auto firstNodeIndex = result.size();
-    Editor->FindNodesInRect(m_GroupBounds, result, true, false);
+    Editor->UpdateGroupTree();
+
+    // Walk group subtree depth first. Nodes which are not live are skipped,
+    // their content is not.
+    auto node = m_FirstGroupChild;
+    while (node)
+    {
+        if (node->IsLive())
+            result.push_back(node);
 
-    for (auto index = firstNodeIndex; index < result.size(); ++index)
-        result[index]->GetGroupedNodes(result, true);
+        if (node->m_FirstGroupChild)
+            node = node->m_FirstGroupChild;
+        else
+        {
+            while (node != this && !node->m_NextGroupSibling)
+                node = node->m_GroupParent;
+
+            node = node != this ? node->m_NextGroupSibling : nullptr;
+        }
+    }
 }
 
 ImRect ed::Node::GetRegionBounds(NodeRegion region) const
@@ -820,6 +933,118 @@ ed::NodeRegion ed::Node::GetRegion(const ImVec2& point) const
 
 
 
+//------------------------------------------------------------------------------
+//
+// Retained Content
+//
+//------------------------------------------------------------------------------
+void ed::RetainedContent::Clear()
+{
+    m_Version           = 0;
+    m_Zoom              = 0.0f;
+    m_CaptureBackground = false;
+    m_ReplayBackground  = false;
+    m_Content.Clear();
+    m_Background.Clear();
+}
+
+void ed::RetainedContent::Layer::Clear()
+{
+    m_Commands.resize(0);
+    m_Vertices.resize(0);
+    m_Indices.resize(0);
+}
+
+bool ed::RetainedContent::Layer::Capture(const ImDrawList* drawList, int firstVertex)
+{
+    m_Commands.resize(0);
+    m_Vertices.resize(0);
+    m_Indices.resize(0);
+
+    const auto& vtxBuffer = drawList->VtxBuffer;
+    const auto& idxBuffer = drawList->IdxBuffer;
+
+    for (auto& cmd : drawList->CmdBuffer)
+    {
+        if (cmd.UserCallback)
+            return false;
+
+        if (cmd.ElemCount == 0)
+            continue;
+
+        auto idxBegin = idxBuffer.Data + cmd.IdxOffset;
+        auto idxEnd   = idxBegin + cmd.ElemCount;
+
+        auto minIndex = *idxBegin;
+        auto maxIndex = *idxBegin;
+        for (auto idx = idxBegin + 1; idx < idxEnd; ++idx)
+        {
+            minIndex = ImMin(minIndex, *idx);
+            maxIndex = ImMax(maxIndex, *idx);
+        }
+
+        // Every vertex has to come from node content.
+        const int vtxStart = static_cast<int>(cmd.VtxOffset) + minIndex;
+        const int vtxEnd   = static_cast<int>(cmd.VtxOffset) + maxIndex + 1;
+        if (vtxStart < firstVertex || vtxEnd > vtxBuffer.Size)
+            return false;
+
+        Command command;
+        command.ClipRect  = cmd.ClipRect;
+        command.TextureId = cmd.TextureId;
+        command.VtxOffset = static_cast<int>(m_Vertices.size());
+        command.VtxCount  = vtxEnd - vtxStart;
+        command.IdxOffset = static_cast<int>(m_Indices.size());
+        command.IdxCount  = static_cast<int>(cmd.ElemCount);
+        m_Commands.push_back(command);
+
+        m_Vertices.insert(m_Vertices.end(), vtxBuffer.Data + vtxStart, vtxBuffer.Data + vtxEnd);
+        for (auto idx = idxBegin; idx < idxEnd; ++idx)
+            m_Indices.push_back(static_cast<ImDrawIdx>(*idx - minIndex));
+    }
+
+    return true;
+}
+
+void ed::RetainedContent::Layer::Replay(ImDrawList* drawList, const ImVec2& offset, const ImVec4& clipRect) const
+{
+    for (auto& command : m_Commands)
+    {
+        // Commands clipped by canvas use current clip rect, ones clipped by user follow the node.
+        const bool hasClipRect = memcmp(&command.ClipRect, &clipRect, sizeof(ImVec4)) != 0;
+        if (hasClipRect)
+            drawList->PushClipRect(
+                ImVec2(command.ClipRect.x, command.ClipRect.y) + offset,
+                ImVec2(command.ClipRect.z, command.ClipRect.w) + offset, true);
+        drawList->PushTextureID(command.TextureId);
+
+        drawList->PrimReserve(command.IdxCount, command.VtxCount);
+
+        auto vtxWrite = drawList->_VtxWritePtr;
+        for (auto vtx = m_Vertices.data() + command.VtxOffset, vtxEnd = vtx + command.VtxCount; vtx < vtxEnd; ++vtx, ++vtxWrite)
+        {
+            *vtxWrite = *vtx;
+            vtxWrite->pos += offset;
+        }
+
+        const auto baseIndex = drawList->_VtxCurrentIdx;
+        auto idxWrite = drawList->_IdxWritePtr;
+        for (auto idx = m_Indices.data() + command.IdxOffset, idxEnd = idx + command.IdxCount; idx < idxEnd; ++idx, ++idxWrite)
+            *idxWrite = static_cast<ImDrawIdx>(*idx + baseIndex);
+
+        drawList->_VtxWritePtr   += command.VtxCount;
+        drawList->_IdxWritePtr   += command.IdxCount;
+        drawList->_VtxCurrentIdx += command.VtxCount;
+
+        drawList->PopTextureID();
+        if (hasClipRect)
+            drawList->PopClipRect();
+    }
+}
+
+
+
+
 //------------------------------------------------------------------------------
 //
 // Link
@@ -853,27 +1078,82 @@ void ed::Link::Draw(ImDrawList* drawList, DrawFlags flags)
 
 void ed::Link::Draw(ImDrawList* drawList, ImU32 color, float extraThickness) const
 {
-    if (!m_IsLive)
+    if (!IsLive())
+        return;
+
+    const auto& curve = GetCurve();
+    const auto  lod   = Editor->GetLevelOfDetail();
+
+    if (lod == LevelOfDetail::Coarse)
+    {
+        drawList->AddLine(curve.P0, curve.P3, color, m_Thickness + extraThickness);
         return;
+    }
 
-    const auto curve = GetCurve();
+    // Arrows are only a few pixels big when zoomed out.
+    const bool hasArrows = lod == LevelOfDetail::Full;
 
     ImDrawList_AddBezierWithArrows(drawList, curve, m_Thickness + extraThickness,
-        m_StartPin && m_StartPin->m_ArrowSize  > 0.0f ? m_StartPin->m_ArrowSize  + extraThickness : 0.0f,
-        m_StartPin && m_StartPin->m_ArrowWidth > 0.0f ? m_StartPin->m_ArrowWidth + extraThickness : 0.0f,
-          m_EndPin &&   m_EndPin->m_ArrowSize  > 0.0f ?   m_EndPin->m_ArrowSize  + extraThickness : 0.0f,
-          m_EndPin &&   m_EndPin->m_ArrowWidth > 0.0f ?   m_EndPin->m_ArrowWidth + extraThickness : 0.0f,
+        hasArrows && m_StartPin && m_StartPin->m_ArrowSize  > 0.0f ? m_StartPin->m_ArrowSize  + extraThickness : 0.0f,
+        hasArrows && m_StartPin && m_StartPin->m_ArrowWidth > 0.0f ? m_StartPin->m_ArrowWidth + extraThickness : 0.0f,
+        hasArrows &&   m_EndPin &&   m_EndPin->m_ArrowSize  > 0.0f ?   m_EndPin->m_ArrowSize  + extraThickness : 0.0f,
+        hasArrows &&   m_EndPin &&   m_EndPin->m_ArrowWidth > 0.0f ?   m_EndPin->m_ArrowWidth + extraThickness : 0.0f,
         true, color, 1.0f);
 }
 
-void ed::Link::UpdateEndpoints()
+bool ed::Link::UpdateEndpoints()
 {
     const auto line = m_StartPin->GetClosestLine(m_EndPin);
-    m_Start = line.A;
-    m_End   = line.B;
+
+    if (m_IsCurveValid
+        && m_Start          == line.A
+        && m_End            == line.B
+        && m_StartDir       == m_StartPin->m_Dir
+        && m_EndDir         == m_EndPin->m_Dir
+        && m_StartStrength  == m_StartPin->m_Strength
+        && m_EndStrength    == m_EndPin->m_Strength
+        && m_StartArrowSize == m_StartPin->m_ArrowSize
+        && m_EndArrowSize   == m_EndPin->m_ArrowSize)
+        return false;
+
+    m_Start          = line.A;
+    m_End            = line.B;
+    m_StartDir       = m_StartPin->m_Dir;
+    m_EndDir         = m_EndPin->m_Dir;
+    m_StartStrength  = m_StartPin->m_Strength;
+    m_EndStrength    = m_EndPin->m_Strength;
+    m_StartArrowSize = m_StartPin->m_ArrowSize;
+    m_EndArrowSize   = m_EndPin->m_ArrowSize;
+
+    m_Curve          = BuildCurve();
+    m_CurveBounds    = BuildCurveBounds();
+    m_IsCurveValid   = true;
+
+    m_Polyline.resize(0);
+
+    return true;
+}
+
+const ed::vector<ImVec2>& ed::Link::GetPolyline() const
+{
+    if (m_Polyline.empty())
+    {
+        // Uniform steps, segment count is picked from second derivative bound
+        // so polyline never deviates from curve more than the tolerance.
+        const auto& c = m_Curve;
+        const auto  d0 = ImLength(c.P0 - c.P1 * 2.0f + c.P2);
+        const auto  d1 = ImLength(c.P1 - c.P2 * 2.0f + c.P3);
+        const auto  segmentCount = ImClamp(static_cast<int>(ImCeil(ImSqrt(0.75f * ImMax(d0, d1) / c_LinkHitTestTolerance))), 1, 256);
+
+        m_Polyline.reserve(segmentCount + 1);
+        for (int i = 0; i <= segmentCount; ++i)
+            m_Polyline.push_back(ImCubicBezier(c.P0, c.P1, c.P2, c.P3, i / static_cast<float>(segmentCount)));
+    }
+
+    return m_Polyline;
 }
 
-ImCubicBezierPoints ed::Link::GetCurve() const
+ImCubicBezierPoints ed::Link::BuildCurve() const
 {
     auto easeLinkStrength = [](const ImVec2& a, const ImVec2& b, float strength)
     {
@@ -888,10 +1168,10 @@ ImCubicBezierPoints ed::Link::GetCurve() const
         return strength;
     };
 
-    const auto startStrength = easeLinkStrength(m_Start, m_End, m_StartPin->m_Strength);
-    const auto   endStrength = easeLinkStrength(m_Start, m_End,   m_EndPin->m_Strength);
-    const auto           cp0 = m_Start + m_StartPin->m_Dir * startStrength;
-    const auto           cp1 =   m_End +   m_EndPin->m_Dir *   endStrength;
+    const auto startStrength = easeLinkStrength(m_Start, m_End, m_StartStrength);
+    const auto   endStrength = easeLinkStrength(m_Start, m_End,   m_EndStrength);
+    const auto           cp0 = m_Start + m_StartDir * startStrength;
+    const auto           cp1 =   m_End +   m_EndDir *   endStrength;
 
     ImCubicBezierPoints result;
     result.P0 = m_Start;
@@ -904,7 +1184,7 @@ ImCubicBezierPoints ed::Link::GetCurve() const
 
 bool ed::Link::TestHit(const ImVec2& point, float extraThickness) const
 {
-    if (!m_IsLive)
+    if (!IsLive())
         return false;
 
     auto bounds = GetBounds();
@@ -914,17 +1194,41 @@ bool ed::Link::TestHit(const ImVec2& point, float extraThickness) const
     if (!bounds.Contains(point))
         return false;
 
-    const auto bezier = GetCurve();
-    const auto result = ImProjectOnCubicBezier(point, bezier.P0, bezier.P1, bezier.P2, bezier.P3, 50);
+    const auto maxDistance = m_Thickness + extraThickness;
+
+    // Coarse links are drawn as straight lines, hit them where they are visible.
+    if (Editor->GetLevelOfDetail() == LevelOfDetail::Coarse)
+    {
+        const auto closest = ImLineClosestPoint(m_Curve.P0, m_Curve.P3, point);
+        return ImLengthSqr(point - closest) <= maxDistance * maxDistance;
+    }
+
+    const auto& polyline = GetPolyline();
+
+    for (int i = 1, count = static_cast<int>(polyline.size()); i < count; ++i)
+    {
+        const auto closest = ImLineClosestPoint(polyline[i - 1], polyline[i], point);
+        if (ImLengthSqr(point - closest) <= maxDistance * maxDistance)
+            return true;
+    }
 
-    return result.Distance <= m_Thickness + extraThickness;
+    return false;
 }
 
 bool ed::Link::TestHit(const ImRect& rect, bool allowIntersect) const
 {
-    if (!m_IsLive)
+    if (!IsLive())
         return false;
 
+    if (Editor->GetLevelOfDetail() == LevelOfDetail::Coarse)
+    {
+        const auto lineBounds = ImRect(ImMin(m_Curve.P0, m_Curve.P3), ImMax(m_Curve.P0, m_Curve.P3));
+        if (rect.Contains(lineBounds))
+            return true;
+
+        return allowIntersect && ImRect_OverlapsLine(rect, m_Curve.P0, m_Curve.P3);
+    }
+
     const auto bounds = GetBounds();
 
     if (rect.Contains(bounds))
@@ -933,70 +1237,55 @@ bool ed::Link::TestHit(const ImRect& rect, bool allowIntersect) const
     if (!allowIntersect || !rect.Overlaps(bounds))
         return false;
 
-    const auto bezier = GetCurve();
-
-    const auto p0 = rect.GetTL();
-    const auto p1 = rect.GetTR();
-    const auto p2 = rect.GetBR();
-    const auto p3 = rect.GetBL();
+    const auto& polyline = GetPolyline();
 
-    if (ImCubicBezierLineIntersect(bezier.P0, bezier.P1, bezier.P2, bezier.P3, p0, p1).Count > 0)
-        return true;
-    if (ImCubicBezierLineIntersect(bezier.P0, bezier.P1, bezier.P2, bezier.P3, p1, p2).Count > 0)
-        return true;
-    if (ImCubicBezierLineIntersect(bezier.P0, bezier.P1, bezier.P2, bezier.P3, p2, p3).Count > 0)
-        return true;
-    if (ImCubicBezierLineIntersect(bezier.P0, bezier.P1, bezier.P2, bezier.P3, p3, p0).Count > 0)
-        return true;
+    for (int i = 1, count = static_cast<int>(polyline.size()); i < count; ++i)
+        if (ImRect_OverlapsLine(rect, polyline[i - 1], polyline[i]))
+            return true;
 
     return false;
 }
 
-ImRect ed::Link::GetBounds() const
+ImRect ed::Link::BuildCurveBounds() const
 {
-    if (m_IsLive)
-    {
-        const auto curve = GetCurve();
-        auto bounds = ImCubicBezierBoundingRect(curve.P0, curve.P1, curve.P2, curve.P3);
-
-        if (bounds.GetWidth() == 0.0f)
-        {
-            bounds.Min.x -= 0.5f;
-            bounds.Max.x += 0.5f;
-        }
+    const auto& curve = m_Curve;
+    auto bounds = ImCubicBezierBoundingRect(curve.P0, curve.P1, curve.P2, curve.P3);
 
-        if (bounds.GetHeight() == 0.0f)
-        {
-            bounds.Min.y -= 0.5f;
-            bounds.Max.y += 0.5f;
-        }
+    if (bounds.GetWidth() == 0.0f)
+    {
+        bounds.Min.x -= 0.5f;
+        bounds.Max.x += 0.5f;
+    }
 
-        if (m_StartPin->m_ArrowSize)
-        {
-            const auto start_dir = ImNormalized(ImCubicBezierTangent(curve.P0, curve.P1, curve.P2, curve.P3, 0.0f));
-            const auto p0 = curve.P0;
-            const auto p1 = curve.P0 - start_dir * m_StartPin->m_ArrowSize;
-            const auto min = ImMin(p0, p1);
-            const auto max = ImMax(p0, p1);
-            auto arrowBounds = ImRect(min, ImMax(max, min + ImVec2(1, 1)));
-            bounds.Add(arrowBounds);
-        }
+    if (bounds.GetHeight() == 0.0f)
+    {
+        bounds.Min.y -= 0.5f;
+        bounds.Max.y += 0.5f;
+    }
 
-        if (m_EndPin->m_ArrowSize)
-        {
-            const auto end_dir = ImNormalized(ImCubicBezierTangent(curve.P0, curve.P1, curve.P2, curve.P3, 1.0f));
-            const auto p0 = curve.P3;
-            const auto p1 = curve.P3 + end_dir * m_EndPin->m_ArrowSize;
-            const auto min = ImMin(p0, p1);
-            const auto max = ImMax(p0, p1);
-            auto arrowBounds = ImRect(min, ImMax(max, min + ImVec2(1, 1)));
-            bounds.Add(arrowBounds);
-        }
+    if (m_StartArrowSize)
+    {
+        const auto start_dir = ImNormalized(ImCubicBezierTangent(curve.P0, curve.P1, curve.P2, curve.P3, 0.0f));
+        const auto p0 = curve.P0;
+        const auto p1 = curve.P0 - start_dir * m_StartArrowSize;
+        const auto min = ImMin(p0, p1);
+        const auto max = ImMax(p0, p1);
+        auto arrowBounds = ImRect(min, ImMax(max, min + ImVec2(1, 1)));
+        bounds.Add(arrowBounds);
+    }
 
-        return bounds;
+    if (m_EndArrowSize)
+    {
+        const auto end_dir = ImNormalized(ImCubicBezierTangent(curve.P0, curve.P1, curve.P2, curve.P3, 1.0f));
+        const auto p0 = curve.P3;
+        const auto p1 = curve.P3 + end_dir * m_EndArrowSize;
+        const auto min = ImMin(p0, p1);
+        const auto max = ImMax(p0, p1);
+        auto arrowBounds = ImRect(min, ImMax(max, min + ImVec2(1, 1)));
+        bounds.Add(arrowBounds);
     }
-    else
-        return ImRect();
+
+    return bounds;
 }
 
 
@@ -1004,133 +1293,424 @@ ImRect ed::Link::GetBounds() const
 
 //------------------------------------------------------------------------------
 //
-// Editor Context
+// Spatial Grid
 //
 //------------------------------------------------------------------------------
-ed::EditorContext::EditorContext(const ax::NodeEditor::Config* config)
-    : m_IsFirstFrame(true)
-    , m_IsWindowActive(false)
-    , m_ShortcutsEnabled(true)
-    , m_MultipleSelectionEnabled(true)
-    , m_Style()
-    , m_Nodes()
-    , m_Pins()
-    , m_Links()
-    , m_SelectionId(1)
-    , m_LastActiveLink(nullptr)
-    , m_Canvas()
-    , m_IsCanvasVisible(false)
-    , m_NodeBuilder(this)
-    , m_HintBuilder(this)
-    , m_CurrentAction(nullptr)
-    , m_NavigateAction(this, m_Canvas)
-    , m_SizeAction(this)
-    , m_DragAction(this)
-    , m_SelectAction(this)
-    , m_ContextMenuAction(this)
-    , m_ShortcutAction(this)
-    , m_CreateItemAction(this)
-    , m_DeleteItemsAction(this)
-    , m_AnimationControllers{ &m_FlowAnimationController }
-    , m_FlowAnimationController(this)
-    , m_DoubleClickedNode(0)
-    , m_DoubleClickedPin(0)
-    , m_DoubleClickedLink(0)
-    , m_BackgroundClicked(false)
-    , m_BackgroundDoubleClicked(false)
-    , m_IsInitialized(false)
-    , m_Settings()
-    , m_Config(config)
-    , m_ExternalChannel(0)
+void ed::SpatialGrid::Clear()
 {
+    m_Cells.clear();
+    m_Entries.clear();
 }
 
-ed::EditorContext::~EditorContext()
+void ed::SpatialGrid::Update(Object* object, const ImRect& bounds)
 {
-    if (m_IsInitialized)
-        SaveSettings();
-
-    for (auto link  : m_Links)  delete link.m_Object;
-    for (auto pin   : m_Pins)   delete pin.m_Object;
-    for (auto node  : m_Nodes)  delete node.m_Object;
+    const auto range = ToCellRange(bounds);
 
-    m_Splitter.ClearFreeMemory();
-}
-
-void ed::EditorContext::Begin(const char* id, const ImVec2& size)
-{
-    if (!m_IsInitialized)
+    auto entryIt = m_Entries.find(object);
+    if (entryIt != m_Entries.end())
     {
-        LoadSettings();
-        m_IsInitialized = true;
-    }
-
-    //ImGui::LogToClipboard();
-    //Log("---- begin ----");
+        if (entryIt->second == range)
+            return;
 
-    for (auto node  : m_Nodes)   node->Reset();
-    for (auto pin   : m_Pins)     pin->Reset();
-    for (auto link  : m_Links)   link->Reset();
-
-    auto drawList = ImGui::GetWindowDrawList();
+        Erase(object, entryIt->second);
+        entryIt->second = range;
+    }
+    else
+        m_Entries.emplace(object, range);
 
-    ImDrawList_SwapSplitter(drawList, m_Splitter);
-    m_ExternalChannel = drawList->_Splitter._Current;
+    Insert(object, range);
+}
 
-    ImGui::PushID(id);
+void ed::SpatialGrid::Remove(Object* object)
+{
+    auto entryIt = m_Entries.find(object);
+    if (entryIt == m_Entries.end())
+        return;
 
-    auto availableContentSize = ImGui::GetContentRegionAvail();
-    ImVec2 canvasSize = ImFloor(size);
-    if (canvasSize.x <= 0.0f)
-        canvasSize.x = ImMax(4.0f, availableContentSize.x);
-    if (canvasSize.y <= 0.0f)
-        canvasSize.y = ImMax(4.0f, availableContentSize.y);
+    Erase(object, entryIt->second);
+    m_Entries.erase(entryIt);
+}
 
-    m_IsCanvasVisible = m_Canvas.Begin(id, canvasSize);
+void ed::SpatialGrid::Query(const ImVec2& point, vector<Object*>& result) const
+{
+    result.resize(0);
 
-    //ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0, 0, 0, 0));
-    //ImGui::BeginChild(id, size, false,
-    //    ImGuiWindowFlags_NoMove |
-    //    ImGuiWindowFlags_NoScrollbar |
-    //    ImGuiWindowFlags_NoScrollWithMouse);
+    auto cellIt = m_Cells.find(CellKey(ToCell(point.x), ToCell(point.y)));
+    if (cellIt != m_Cells.end())
+        result.insert(result.end(), cellIt->second.begin(), cellIt->second.end());
+}
 
-    ImGui::CaptureKeyboardFromApp();
+void ed::SpatialGrid::Query(const ImRect& rect, vector<Object*>& result) const
+{
+    result.resize(0);
 
-    m_IsWindowActive = ImGui::IsWindowFocused();
+    const auto range = ToCellRange(rect);
 
-    //
-	m_NavigateAction.SetWindow(m_Canvas.ViewRect().Min, m_Canvas.ViewRect().GetSize());
+    const auto rangeCellCount = (static_cast<int64_t>(range.MaxX) - range.MinX + 1) * (static_cast<int64_t>(range.MaxY) - range.MinY + 1);
 
-    if (m_CurrentAction && m_CurrentAction->IsDragging() && m_NavigateAction.MoveOverEdge())
+    if (rangeCellCount > static_cast<int64_t>(m_Cells.size()))
     {
-        auto& io = ImGui::GetIO();
-        auto offset = m_NavigateAction.GetMoveOffset();
-        for (int i = 0; i < 5; ++i)
-            io.MouseClickedPos[i] = io.MouseClickedPos[i] - offset;
+        // Query covers more cells than there are occupied, visit occupied ones.
+        for (auto& cell : m_Cells)
+        {
+            const auto x = static_cast<int>(static_cast<uint32_t>(cell.first >> 32));
+            const auto y = static_cast<int>(static_cast<uint32_t>(cell.first));
+            if (x >= range.MinX && x <= range.MaxX && y >= range.MinY && y <= range.MaxY)
+                result.insert(result.end(), cell.second.begin(), cell.second.end());
+        }
     }
     else
-        m_NavigateAction.StopMoveOverEdge();
+    {
+        for (int y = range.MinY; y <= range.MaxY; ++y)
+            for (int x = range.MinX; x <= range.MaxX; ++x)
+            {
+                auto cellIt = m_Cells.find(CellKey(x, y));
+                if (cellIt != m_Cells.end())
+                    result.insert(result.end(), cellIt->second.begin(), cellIt->second.end());
+            }
+    }
 
-    m_Canvas.SetView(m_NavigateAction.GetView());
+    // Objects spanning several cells are reported once.
+    if (range.MinX != range.MaxX || range.MinY != range.MaxY)
+    {
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+}
 
-    // #debug #clip
-    //ImGui::Text("CLIP = { x=%g y=%g w=%g h=%g r=%g b=%g }",
+int ed::SpatialGrid::ToCell(float v) const
+{
+    const float c_MaxCell = static_cast<float>(1 << 30);
+
+    return static_cast<int>(ImClamp(ImFloor(v * m_InvCellSize), -c_MaxCell, c_MaxCell));
+}
+
+ed::SpatialGrid::CellRange ed::SpatialGrid::ToCellRange(const ImRect& bounds) const
+{
+    return CellRange{ ToCell(bounds.Min.x), ToCell(bounds.Min.y), ToCell(bounds.Max.x), ToCell(bounds.Max.y) };
+}
+
+void ed::SpatialGrid::Insert(Object* object, const CellRange& range)
+{
+    for (int y = range.MinY; y <= range.MaxY; ++y)
+        for (int x = range.MinX; x <= range.MaxX; ++x)
+            m_Cells[CellKey(x, y)].push_back(object);
+}
+
+void ed::SpatialGrid::Erase(Object* object, const CellRange& range)
+{
+    for (int y = range.MinY; y <= range.MaxY; ++y)
+        for (int x = range.MinX; x <= range.MaxX; ++x)
+        {
+            auto cellIt = m_Cells.find(CellKey(x, y));
+            if (cellIt == m_Cells.end())
+                continue;
+
+            auto& objects = cellIt->second;
+            auto objectIt = std::find(objects.begin(), objects.end(), object);
+            if (objectIt != objects.end())
+            {
+                *objectIt = objects.back();
+                objects.pop_back();
+            }
+
+            if (objects.empty())
+                m_Cells.erase(cellIt);
+        }
+}
+
+
+
+
+//------------------------------------------------------------------------------
+//
+// Node Batcher
+//
+//------------------------------------------------------------------------------
+int ed::NodeBatcher::Build(const ImRect* bounds, int count)
+{
+    m_Batches.assign(count, 0);
+    m_Overlaps.resize(0);
+
+    if (count == 0)
+        return 0;
+
+    // Bin bounds into uniform grid of cells about the size of average node.
+    // Cells grow with the largest node, so it does not spread over too many of them.
+    ImRect area = bounds[0];
+    ImVec2 totalSize;
+    ImVec2 maxSize;
+    for (int i = 0; i < count; ++i)
+    {
+        area.Add(bounds[i]);
+        totalSize += bounds[i].GetSize();
+        maxSize    = ImMax(maxSize, bounds[i].GetSize());
+    }
+
+    const auto cellSize    = ImMax(ImMax(ImMax(totalSize.x, totalSize.y) / count, ImMax(maxSize.x, maxSize.y) / c_MaxBatchCellsPerAxis), 1.0f);
+    const auto invCellSize = 1.0f / cellSize;
+    const auto toCell      = [&area, invCellSize](const ImVec2& p) { return ImVec2(ImFloor((p.x - area.Min.x) * invCellSize), ImFloor((p.y - area.Min.y) * invCellSize)); };
+    const auto cellKey     = [](const ImVec2& cell) { return (static_cast<uint64_t>(cell.y) << 32) | static_cast<uint32_t>(cell.x); };
+
+    m_Cells.resize(0);
+    for (int i = 0; i < count; ++i)
+    {
+        const auto cellMin = toCell(bounds[i].Min);
+        const auto cellMax = toCell(bounds[i].Max);
+        for (auto y = cellMin.y; y <= cellMax.y; y += 1.0f)
+            for (auto x = cellMin.x; x <= cellMax.x; x += 1.0f)
+                m_Cells.push_back(std::make_pair(cellKey(ImVec2(x, y)), i));
+    }
+
+    std::sort(m_Cells.begin(), m_Cells.end());
+
+    // Test bounds sharing a cell. Pair is reported only by the cell holding
+    // top-left corner of the intersection, so it is not counted twice.
+    //
+    // Densely packed nodes gain nothing from batching, draw order is kept.
+    // Limit is checked per pair, a single cell can hold every node.
+    const auto maxOverlaps = static_cast<size_t>(count) * c_MaxBatchOverlapsPerNode;
+    for (auto cell = m_Cells.begin(), cellsEnd = m_Cells.end(); cell != cellsEnd; )
+    {
+        auto cellEnd = cell + 1;
+        while (cellEnd != cellsEnd && cellEnd->first == cell->first)
+            ++cellEnd;
+
+        for (auto lhs = cell; lhs != cellEnd; ++lhs)
+        {
+            for (auto rhs = lhs + 1; rhs != cellEnd; ++rhs)
+            {
+                const auto& a = bounds[lhs->second];
+                const auto& b = bounds[rhs->second];
+                if (a.Min.x > b.Max.x || b.Min.x > a.Max.x || a.Min.y > b.Max.y || b.Min.y > a.Max.y)
+                    continue;
+
+                if (cellKey(toCell(ImMax(a.Min, b.Min))) != cell->first)
+                    continue;
+
+                if (m_Overlaps.size() == maxOverlaps)
+                {
+                    for (int i = 0; i < count; ++i)
+                        m_Batches[i] = i;
+                    return count;
+                }
+
+                m_Overlaps.push_back(std::make_pair(lhs->second, rhs->second));
+            }
+        }
+
+        cell = cellEnd;
+    }
+
+    std::sort(m_Overlaps.begin(), m_Overlaps.end(), [](const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) { return lhs.second < rhs.second; });
+
+    // Node is drawn after every earlier node it overlaps.
+    int batchCount = 1;
+    auto overlap    = m_Overlaps.begin();
+    auto overlapEnd = m_Overlaps.end();
+    for (int i = 0; i < count; ++i)
+    {
+        for (; overlap != overlapEnd && overlap->second == i; ++overlap)
+            m_Batches[i] = ImMax(m_Batches[i], m_Batches[overlap->first] + 1);
+
+        batchCount = ImMax(batchCount, m_Batches[i] + 1);
+    }
+
+    return batchCount;
+}
+
+
+
+
+//------------------------------------------------------------------------------
+//
+// Dead Objects
+//
+//------------------------------------------------------------------------------
+static bool IsDeadObject(const ed::vector<ed::Object*>& deadObjects, ed::Object* object)
+{
+    return object && std::binary_search(deadObjects.begin(), deadObjects.end(), object);
+}
+
+template <typename T>
+static void RemoveDeadObjects(ed::vector<T*>& objects, const ed::vector<ed::Object*>& deadObjects)
+{
+    auto endIt = std::remove_if(objects.begin(), objects.end(), [&deadObjects](T* object) { return IsDeadObject(deadObjects, object); });
+    objects.erase(endIt, objects.end());
+}
+
+
+
+
+//------------------------------------------------------------------------------
+//
+// Editor Context
+//
+//------------------------------------------------------------------------------
+ed::EditorContext::EditorContext(const ax::NodeEditor::Config* config)
+    : m_IsFirstFrame(true)
+    , m_IsWindowActive(false)
+    , m_ShortcutsEnabled(true)
+    , m_MultipleSelectionEnabled(true)
+    , m_Style()
+    , m_Nodes()
+    , m_Pins()
+    , m_Links()
+    , m_SortedLinkCount(0)
+    , m_SelectionId(1)
+    , m_LastSelectionId(1)
+    , m_LastActiveLink(nullptr)
+    , m_FrameIndex(0)
+    , m_ReclaimedObjectCount(0)
+    , m_FrameStats()
+    , m_LastFrameStats()
+    , m_FrameStatsStart()
+    , m_FrameStatsLap()
+    , m_FrameStatsHistory()
+    , m_FrameStatsHistoryNext(0)
+    , m_FrameStatsScratchGrowthCount(0)
+    , m_Canvas()
+    , m_IsCanvasVisible(false)
+    , m_NodeBuilder(this)
+    , m_HintBuilder(this)
+    , m_CurrentAction(nullptr)
+    , m_NavigateAction(this, m_Canvas)
+    , m_SizeAction(this)
+    , m_DragAction(this)
+    , m_SelectAction(this)
+    , m_ContextMenuAction(this)
+    , m_ShortcutAction(this)
+    , m_CreateItemAction(this)
+    , m_DeleteItemsAction(this)
+    , m_AnimationControllers{ &m_FlowAnimationController }
+    , m_FlowAnimationController(this)
+    , m_DoubleClickedNode(0)
+    , m_DoubleClickedPin(0)
+    , m_DoubleClickedLink(0)
+    , m_BackgroundClicked(false)
+    , m_BackgroundDoubleClicked(false)
+    , m_IsInitialized(false)
+    , m_Settings()
+    , m_Config(config)
+    , m_ExternalChannel(0)
+{
+    m_NodePool.Reserve(m_Config.NodeCapacityHint);
+    m_PinPool.Reserve(m_Config.PinCapacityHint);
+    m_LinkPool.Reserve(m_Config.LinkCapacityHint);
+
+    m_Canvas.SetTransformCallback(m_Config.CanvasTransformCallback);
+}
+
+ed::EditorContext::~EditorContext()
+{
+    if (m_IsInitialized)
+        SaveSettings();
+
+    for (auto link  : m_Links)  m_LinkPool.Destroy(link);
+    for (auto pin   : m_Pins)   m_PinPool.Destroy(pin);
+    for (auto node  : m_Nodes)  m_NodePool.Destroy(node);
+
+    m_Splitter.ClearFreeMemory();
+}
+
+void ed::EditorContext::Begin(const char* id, const ImVec2& size)
+{
+    if (!m_IsInitialized)
+    {
+        LoadSettings();
+        m_IsInitialized = true;
+    }
+
+    //ImGui::LogToClipboard();
+    //Log("---- begin ----");
+
+    BeginFrameStats();
+
+    ++m_FrameIndex;
+
+    // Start tracking selection changes of this frame. Selected objects removed
+    // by CollectDeadObjects() already count as a change.
+    for (auto object : m_SelectionChanges)
+    {
+        object->m_WasSelected        = object->m_IsSelected;
+        object->m_IsSelectionChanged = false;
+    }
+    m_SelectionChanges.resize(0);
+    m_LastSelectionId = m_SelectionId;
+
+    if (m_Config.DeadObjectLifetime > 0)
+        CollectDeadObjects();
+
+    RecordFrameStat(nullptr);
+
+    m_NodeStates.Reset();
+    m_PinStates.Reset();
+    m_LinkStates.Reset();
+
+    RecordFrameStat(&FrameStats::Reset);
+
+    auto drawList = ImGui::GetWindowDrawList();
+
+    ImDrawList_SwapSplitter(drawList, m_Splitter);
+    m_ExternalChannel = drawList->_Splitter._Current;
+
+    ImGui::PushID(id);
+
+    auto availableContentSize = ImGui::GetContentRegionAvail();
+    ImVec2 canvasSize = ImFloor(size);
+    if (canvasSize.x <= 0.0f)
+        canvasSize.x = ImMax(4.0f, availableContentSize.x);
+    if (canvasSize.y <= 0.0f)
+        canvasSize.y = ImMax(4.0f, availableContentSize.y);
+
+    m_IsCanvasVisible = m_Canvas.Begin(id, canvasSize);
+
+    //ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0, 0, 0, 0));
+    //ImGui::BeginChild(id, size, false,
+    //    ImGuiWindowFlags_NoMove |
+    //    ImGuiWindowFlags_NoScrollbar |
+    //    ImGuiWindowFlags_NoScrollWithMouse);
+
+    ImGui::CaptureKeyboardFromApp();
+
+    m_IsWindowActive = ImGui::IsWindowFocused();
+
+    //
+	m_NavigateAction.SetWindow(m_Canvas.ViewRect().Min, m_Canvas.ViewRect().GetSize());
+
+    if (m_CurrentAction && m_CurrentAction->IsDragging() && m_NavigateAction.MoveOverEdge())
+    {
+        auto& io = ImGui::GetIO();
+        auto offset = m_NavigateAction.GetMoveOffset();
+        for (int i = 0; i < 5; ++i)
+            io.MouseClickedPos[i] = io.MouseClickedPos[i] - offset;
+    }
+    else
+        m_NavigateAction.StopMoveOverEdge();
+
+    m_Canvas.SetView(m_NavigateAction.GetView());
+
+    // #debug #clip
+    //ImGui::Text("CLIP = { x=%g y=%g w=%g h=%g r=%g b=%g }",
     //    clipMin.x, clipMin.y, clipMax.x - clipMin.x, clipMax.y - clipMin.y, clipMax.x, clipMax.y);
 
     // Reserve channels for background and links
     ImDrawList_ChannelsGrow(drawList, c_NodeStartChannel);
 
-    if (HasSelectionChanged())
-        ++m_SelectionId;
-
-    m_LastSelectedObjects = m_SelectedObjects;
+    RecordFrameStat(nullptr);
 }
 
 void ed::EditorContext::End()
 {
+    RecordFrameStat(&FrameStats::NodeBuilding);
+
+    SortLinks();
+
     //auto& io          = ImGui::GetIO();
     auto  control     = BuildControl(m_CurrentAction && m_CurrentAction->IsDragging()); // NavigateAction.IsMovingOverEdge()
     auto  drawList    = ImGui::GetWindowDrawList();
+
+    RecordFrameStat(&FrameStats::BuildControl);
     //auto& editorStyle = GetStyle();
 
     m_DoubleClickedNode       = control.DoubleClickedNode ? control.DoubleClickedNode->m_ID : 0;
@@ -1148,14 +1728,19 @@ void ed::EditorContext::End()
     const bool isDragging  = m_CurrentAction && m_CurrentAction->AsDrag()   != nullptr;
     //const bool isSizing    = CurrentAction && CurrentAction->AsSize()   != nullptr;
 
+    // Cull nodes and links
+    const auto& clipRect = ImGui::GetCurrentWindowRead()->ClipRect;
+    m_NodeStates.Cull(clipRect);
+    m_LinkStates.Cull(clipRect);
+
     // Draw nodes
     for (auto node : m_Nodes)
-        if (node->m_IsLive && node->IsVisible())
+        if (node->IsCulledVisible())
             node->Draw(drawList);
 
     // Draw links
     for (auto link : m_Links)
-        if (link->m_IsLive && link->IsVisible())
+        if (link->IsCulledVisible())
             link->Draw(drawList);
 
     // Highlight selected objects
@@ -1185,6 +1770,8 @@ void ed::EditorContext::End()
     for (auto controller : m_AnimationControllers)
         controller->Draw(drawList);
 
+    RecordFrameStat(&FrameStats::Draw);
+
     if (m_CurrentAction && !m_CurrentAction->Process(control))
         m_CurrentAction = nullptr;
 
@@ -1236,92 +1823,152 @@ void ed::EditorContext::End()
     if (m_CurrentAction)
         ImGui::SetMouseCursor(m_CurrentAction->GetCursor());
 
+    RecordFrameStat(&FrameStats::Actions);
+
     // Draw selection rectangle
     m_SelectAction.Draw(drawList);
 
-    bool sortGroups = false;
+    RecordFrameStat(&FrameStats::Draw);
+
     if (control.ActiveNode)
     {
         if (!IsGroup(control.ActiveNode))
         {
             // Bring active node to front
-            auto activeNodeIt = std::find(m_Nodes.begin(), m_Nodes.end(), control.ActiveNode);
-            std::rotate(activeNodeIt, activeNodeIt + 1, m_Nodes.end());
+            BringNodeToFront(control.ActiveNode);
         }
         else if (!isDragging && m_CurrentAction && m_CurrentAction->AsDrag())
         {
             // Bring content of dragged group to front
-            std::vector<Node*> nodes;
+            ScratchVector<Node*> scratch(m_Scratch);
+            auto& nodes = *scratch;
             control.ActiveNode->GetGroupedNodes(nodes);
 
-            std::stable_partition(m_Nodes.begin(), m_Nodes.end(), [&nodes](Node* node)
-            {
-                return std::find(nodes.begin(), nodes.end(), node) == nodes.end();
-            });
-
-            sortGroups = true;
+            BringNodesToFront(nodes);
         }
     }
 
-    // Sort nodes if bounds of node changed
-    if (sortGroups || ((m_Settings.m_DirtyReason & (SaveReasonFlags::Position | SaveReasonFlags::Size)) != SaveReasonFlags::None))
+    RecordFrameStat(&FrameStats::GroupSort);
+
+# if 1
+    // Every node has few channels assigned. Nodes which do not overlap are
+    // batched and share channels, empty channels are skipped. Batches are
+    // placed in node drawing order in place of channels reserved for links
+    // and nodes, links stay between groups and normal nodes.
     {
-        // Bring all groups before regular nodes
-        auto groupsItEnd = std::stable_partition(m_Nodes.begin(), m_Nodes.end(), IsGroup);
+        drawList->ChannelsSetCurrent(0);
 
-        // Sort groups by area
-        std::sort(m_Nodes.begin(), groupsItEnd, [this](Node* lhs, Node* rhs)
+        auto& splitter = drawList->_Splitter;
+
+        if (m_Config.EnableFrameStats)
         {
-            const auto& lhsSize = lhs == m_SizeAction.m_SizedNode ? m_SizeAction.GetStartGroupBounds().GetSize() : lhs->m_GroupBounds.GetSize();
-            const auto& rhsSize = rhs == m_SizeAction.m_SizedNode ? m_SizeAction.GetStartGroupBounds().GetSize() : rhs->m_GroupBounds.GetSize();
+            m_FrameStats.ChannelCount  = splitter._Count;
+            m_FrameStats.DrawCallCount = ImDrawList_CountDrawCalls(drawList);
+        }
 
-            const auto lhsArea = lhsSize.x * lhsSize.y;
-            const auto rhsArea = rhsSize.x * rhsSize.y;
+        const auto margin = GetNodeDrawMargin();
 
-            return lhsArea > rhsArea;
-        });
-    }
+        m_BatchedNodes.resize(0);
+        m_BatchedBounds.resize(0);
+        for (auto node : m_Nodes)
+        {
+            if (!node->IsLive())
+                continue;
 
-# if 1
-    // Every node has few channels assigned. Grow channel list
-    // to hold twice as much of channels and place them in
-    // node drawing order.
-    {
-        // Copy group nodes
-        auto liveNodeCount = static_cast<int>(std::count_if(m_Nodes.begin(), m_Nodes.end(), [](Node* node) { return node->m_IsLive; }));
+            // Content was captured this frame, user background is complete only now.
+            auto& retained = node->m_Retained;
+            if (retained.m_CaptureBackground)
+            {
+                retained.m_CaptureBackground = false;
+                drawList->ChannelsSetCurrent(node->m_Channel + c_NodeUserBackgroundChannel);
+                if (!retained.m_Background.Capture(drawList, 0))
+                    retained.Clear();
+            }
+            else if (retained.m_ReplayBackground)
+            {
+                retained.m_ReplayBackground = false;
+                drawList->ChannelsSetCurrent(node->m_Channel + c_NodeUserBackgroundChannel);
+                retained.m_Background.Replay(drawList, node->m_LayoutPosition - retained.m_Position, retained.m_ClipRect);
+            }
+
+            m_BatchedNodes.push_back(node);
+            m_BatchedBounds.push_back(GetNodeDrawBounds(node, margin));
+        }
+
+        drawList->ChannelsSetCurrent(0);
 
-        // Reserve two additional channels for sorted list of channels
-        auto nodeChannelCount = drawList->_Splitter._Count;
-        ImDrawList_ChannelsGrow(drawList, drawList->_Splitter._Count + c_ChannelsPerNode * liveNodeCount + c_LinkChannelCount);
+        const auto liveNodeCount  = static_cast<int>(m_BatchedNodes.size());
+        const auto liveGroupCount = static_cast<int>(std::find_if(m_BatchedNodes.begin(), m_BatchedNodes.end(), [](Node* node) { return !IsGroup(node); }) - m_BatchedNodes.begin());
 
-        int targetChannel = nodeChannelCount;
+        const auto nodeChannelEnd = splitter._Count;
+        int        targetChannel  = nodeChannelEnd;
 
-        auto copyNode = [&targetChannel, drawList](Node* node)
+        auto copyNodes = [&](int first, int last)
         {
-            if (!node->m_IsLive)
-                return;
+            const auto batchCount = m_NodeBatcher.Build(m_BatchedBounds.data() + first, last - first);
 
-            for (int i = 0; i < c_ChannelsPerNode; ++i)
-                ImDrawList_SwapChannels(drawList, node->m_Channel + i, targetChannel + i);
+            // Batch gets target channel only for slots some of its nodes drew into.
+            m_BatchedChannels.assign(batchCount * c_ChannelsPerNode, -1);
+            for (int i = first; i < last; ++i)
+            {
+                auto node  = m_BatchedNodes[i];
+                auto slots = m_BatchedChannels.data() + m_NodeBatcher.Batch(i - first) * c_ChannelsPerNode;
+                for (int j = 0; j < c_ChannelsPerNode; ++j)
+                    if (!ImDrawListSplitter_IsChannelEmpty(&splitter, node->m_Channel + j))
+                        slots[j] = 0;
+            }
 
-            node->m_Channel = targetChannel;
-            targetChannel += c_ChannelsPerNode;
-        };
+            const auto channelStart = targetChannel;
+            for (auto& channel : m_BatchedChannels)
+                if (channel >= 0)
+                    channel = targetChannel++;
+
+            ImDrawList_ChannelsGrow(drawList, splitter._Count + targetChannel - channelStart);
+
+            for (int i = first; i < last; ++i)
+            {
+                auto node  = m_BatchedNodes[i];
+                auto slots = m_BatchedChannels.data() + m_NodeBatcher.Batch(i - first) * c_ChannelsPerNode;
+
+                for (int j = 0; j < c_ChannelsPerNode; ++j)
+                    if (slots[j] >= 0)
+                        ImDrawListSplitter_AppendChannel(&splitter, node->m_Channel + j, slots[j]);
 
-        auto groupsItEnd = std::find_if(m_Nodes.begin(), m_Nodes.end(), [](Node* node) { return !IsGroup(node); });
+                // Channels of the node are no longer consecutive, nothing is drawn
+                // into them until node is submitted again.
+                node->m_Channel = channelStart;
+            }
+        };
 
         // Copy group nodes
-        std::for_each(m_Nodes.begin(), groupsItEnd, copyNode);
+        copyNodes(0, liveGroupCount);
 
         // Copy links
+        ImDrawList_ChannelsGrow(drawList, splitter._Count + c_LinkChannelCount);
         for (int i = 0; i < c_LinkChannelCount; ++i, ++targetChannel)
             ImDrawList_SwapChannels(drawList, c_LinkStartChannel + i, targetChannel);
 
         // Copy normal nodes
-        std::for_each(groupsItEnd, m_Nodes.end(), copyNode);
+        copyNodes(liveGroupCount, liveNodeCount);
+
+        // Everything between link channels and copied channels is empty by now,
+        // move copied channels down and drop the rest.
+        const auto copiedChannelCount = targetChannel - nodeChannelEnd;
+        const auto channelOffset      = nodeChannelEnd - c_LinkStartChannel;
+        for (int i = 0; i < copiedChannelCount; ++i)
+            ImDrawList_SwapChannels(drawList, c_LinkStartChannel + i, nodeChannelEnd + i);
+        splitter._Count = c_LinkStartChannel + copiedChannelCount;
+
+        for (auto node : m_BatchedNodes)
+            node->m_Channel -= channelOffset;
+
+        if (m_Config.EnableFrameStats)
+            m_FrameStats.CompactChannelCount = splitter._Count;
     }
 # endif
 
+    RecordFrameStat(&FrameStats::ChannelReorder);
+
     // ImGui::PopClipRect();
 
     // Draw grid
@@ -1333,39 +1980,101 @@ void ed::EditorContext::End()
 
         auto& editorStyle = NodeEditor::GetStyle();
         ImVec2 offset    = m_Canvas.ViewOrigin() * (1.0f / m_Canvas.ViewScale());
-        ImU32 GRID_COLOR = GetColor(StyleColor_Grid, ImClamp(m_Canvas.ViewScale() * m_Canvas.ViewScale(), 0.0f, 1.0f));
-        float GRID_SX    = editorStyle.GridSize.x;// * m_Canvas.ViewScale();
-        float GRID_SY    = editorStyle.GridSize.y;// * m_Canvas.ViewScale();
         float THICKNESS  = editorStyle.GridLineThickness;// * m_Canvas.ViewScale();
         ImVec2 VIEW_POS  = m_Canvas.ViewRect().Min;
         ImVec2 VIEW_SIZE = m_Canvas.ViewRect().GetSize();
 
         drawList->AddRectFilled(VIEW_POS, VIEW_POS + VIEW_SIZE, GetColor(StyleColor_Bg));
 
-        for (float x = fmodf(offset.x, GRID_SX); x < VIEW_SIZE.x; x += GRID_SX)
-            drawList->AddLine(ImVec2(x, 0.0f) + VIEW_POS, ImVec2(x, VIEW_SIZE.y) + VIEW_POS, GRID_COLOR, THICKNESS);
-        for (float y = fmodf(offset.y, GRID_SY); y < VIEW_SIZE.y; y += GRID_SY)
-            drawList->AddLine(ImVec2(0.0f, y) + VIEW_POS, ImVec2(VIEW_SIZE.x, y) + VIEW_POS, GRID_COLOR, THICKNESS);
-    }
-# endif
+        // Grid spacing grows in decades when view is zoomed out. Finest level fades out as
+        // its lines get close on screen, so number of lines is bounded by view size.
+        const auto baseSize = ImMin(editorStyle.GridSize.x, editorStyle.GridSize.y);
+        if (baseSize > 0.0f)
+        {
+            const auto viewScale  = m_Canvas.ViewScale();
+            const auto minSpacing = baseSize * c_GridFadeOutSpacing;
 
-# if 0
-    {
-        auto userChannel = drawList->_Splitter._Count;
-        auto channelsToCopy = c_UserLayersCount;
-        ImDrawList_ChannelsGrow(drawList, userChannel + channelsToCopy);
-        for (int i = 0; i < channelsToCopy; ++i)
-            ImDrawList_SwapChannels(drawList, userChannel + i, c_UserLayerChannelStart + i);
-    }
-# endif
+            auto levelScale = 1.0f;
+            while (baseSize * levelScale * viewScale < minSpacing)
+                levelScale *= c_GridLevelRatio;
 
-# if 0
-    {
-        auto preOffset  = ImVec2(0, 0);
-        auto postOffset = m_OldCanvas.WindowScreenPos + m_OldCanvas.ClientOrigin;
-        auto scale      = m_OldCanvas.Zoom;
+            const auto fineSpacing = editorStyle.GridSize * levelScale;
+            const auto fade        = ImSaturate((baseSize * levelScale * viewScale - minSpacing) / (baseSize - minSpacing));
+            const auto fineColor   = GetColor(StyleColor_Grid, fade);
+            const auto coarseColor = GetColor(StyleColor_Grid, 1.0f);
 
-        ImDrawList_TransformChannels(drawList,                        0,                            1, preOffset, scale, postOffset);
+            if (editorStyle.GridTexture)
+            {
+                // Texture holds single grid cell and is repeated over the view.
+                auto drawLevel = [&](const ImVec2& spacing, ImU32 color)
+                {
+                    drawList->AddImage(editorStyle.GridTexture, VIEW_POS, VIEW_POS + VIEW_SIZE,
+                        ImVec2(VIEW_POS.x / spacing.x, VIEW_POS.y / spacing.y),
+                        ImVec2((VIEW_POS.x + VIEW_SIZE.x) / spacing.x, (VIEW_POS.y + VIEW_SIZE.y) / spacing.y),
+                        color);
+                };
+
+                if (fade > 0.0f)
+                    drawLevel(fineSpacing, fineColor);
+                if (fade < 1.0f)
+                    drawLevel(fineSpacing * c_GridLevelRatio, coarseColor);
+            }
+            else
+            {
+                // Lines shared with coarser level are skipped.
+                const int  levelRatio = static_cast<int>(c_GridLevelRatio);
+                const bool hasCoarse  = fade < 1.0f;
+                const auto lineColor  = hasCoarse ? fineColor : coarseColor;
+
+                auto isSkipped = [hasCoarse, levelRatio](long long index)
+                {
+                    return hasCoarse && index % levelRatio == 0;
+                };
+
+                if (fade > 0.0f)
+                {
+                    float x = fmodf(offset.x, fineSpacing.x);
+                    for (auto index = static_cast<long long>(ImFloor((VIEW_POS.x + x) / fineSpacing.x + 0.5f)); x < VIEW_SIZE.x; x += fineSpacing.x, ++index)
+                        if (!isSkipped(index))
+                            drawList->AddLine(ImVec2(x, 0.0f) + VIEW_POS, ImVec2(x, VIEW_SIZE.y) + VIEW_POS, lineColor, THICKNESS);
+                    float y = fmodf(offset.y, fineSpacing.y);
+                    for (auto index = static_cast<long long>(ImFloor((VIEW_POS.y + y) / fineSpacing.y + 0.5f)); y < VIEW_SIZE.y; y += fineSpacing.y, ++index)
+                        if (!isSkipped(index))
+                            drawList->AddLine(ImVec2(0.0f, y) + VIEW_POS, ImVec2(VIEW_SIZE.x, y) + VIEW_POS, lineColor, THICKNESS);
+                }
+
+                if (hasCoarse)
+                {
+                    const auto coarseSpacing = fineSpacing * c_GridLevelRatio;
+                    for (float x = fmodf(offset.x, coarseSpacing.x); x < VIEW_SIZE.x; x += coarseSpacing.x)
+                        drawList->AddLine(ImVec2(x, 0.0f) + VIEW_POS, ImVec2(x, VIEW_SIZE.y) + VIEW_POS, coarseColor, THICKNESS);
+                    for (float y = fmodf(offset.y, coarseSpacing.y); y < VIEW_SIZE.y; y += coarseSpacing.y)
+                        drawList->AddLine(ImVec2(0.0f, y) + VIEW_POS, ImVec2(VIEW_SIZE.x, y) + VIEW_POS, coarseColor, THICKNESS);
+                }
+            }
+        }
+    }
+# endif
+
+    RecordFrameStat(&FrameStats::Grid);
+
+# if 0
+    {
+        auto userChannel = drawList->_Splitter._Count;
+        auto channelsToCopy = c_UserLayersCount;
+        ImDrawList_ChannelsGrow(drawList, userChannel + channelsToCopy);
+        for (int i = 0; i < channelsToCopy; ++i)
+            ImDrawList_SwapChannels(drawList, userChannel + i, c_UserLayerChannelStart + i);
+    }
+# endif
+
+# if 0
+    {
+        auto preOffset  = ImVec2(0, 0);
+        auto postOffset = m_OldCanvas.WindowScreenPos + m_OldCanvas.ClientOrigin;
+        auto scale      = m_OldCanvas.Zoom;
+
+        ImDrawList_TransformChannels(drawList,                        0,                            1, preOffset, scale, postOffset);
         ImDrawList_TransformChannels(drawList, c_BackgroundChannelStart, drawList->_ChannelsCount - 1, preOffset, scale, postOffset);
 
         auto clipTranslation = m_OldCanvas.WindowScreenPos - m_OldCanvas.FromScreen(m_OldCanvas.WindowScreenPos);
@@ -1414,204 +2123,708 @@ void ed::EditorContext::End()
     }
 # endif
 
-    UpdateAnimations();
+    RecordFrameStat(&FrameStats::ChannelReorder);
+
+    UpdateAnimations();
+
+    RecordFrameStat(nullptr);
+
+    drawList->ChannelsMerge();
+
+    if (m_Config.EnableFrameStats)
+        m_FrameStats.MergedDrawCallCount = ImDrawList_CountDrawCalls(drawList);
+
+    RecordFrameStat(&FrameStats::ChannelsMerge);
+
+    // #debug
+    // drawList->AddRectFilled(ImVec2(-10.0f, -10.0f), ImVec2(10.0f, 10.0f), IM_COL32(255, 0, 255, 255));
+
+    // ImGui::EndChild();
+    // ImGui::PopStyleColor();
+    if (m_IsCanvasVisible)
+        m_Canvas.End();
+
+    RecordFrameStat(&FrameStats::Canvas);
+
+    ImDrawList_SwapSplitter(drawList, m_Splitter);
+
+    // Draw border
+    {
+        auto& style = ImGui::GetStyle();
+        auto borderShadoColor = style.Colors[ImGuiCol_BorderShadow];
+        auto borderColor = style.Colors[ImGuiCol_Border];
+        drawList->AddRect(m_Canvas.Rect().Min + ImVec2(1, 1), m_Canvas.Rect().Max - ImVec2(1, 1), ImColor(borderShadoColor));
+        drawList->AddRect(m_Canvas.Rect().Min, m_Canvas.Rect().Max, ImColor(borderColor));
+    }
+
+    // ShowMetrics(control);
+
+    ImGui::PopID();
+
+    if (!m_CurrentAction && m_IsFirstFrame && !m_Settings.m_Selection.empty())
+    {
+        ClearSelection();
+        for (auto id : m_Settings.m_Selection)
+            if (auto object = FindObject(id))
+                SelectObject(object);
+    }
+
+    if (HasSelectionChanged())
+        MakeDirty(SaveReasonFlags::Selection);
+
+    RecordFrameStat(nullptr);
+
+    if (m_Settings.m_IsDirty && !m_CurrentAction)
+        SaveSettings();
+
+    RecordFrameStat(&FrameStats::SaveSettings);
+
+    EndFrameStats();
+
+    m_IsFirstFrame = false;
+}
+
+bool ed::EditorContext::DoLink(LinkId id, PinId startPinId, PinId endPinId, ImU32 color, float thickness)
+{
+    //auto& editorStyle = GetStyle();
+
+    auto startPin = FindPin(startPinId);
+    auto endPin   = FindPin(endPinId);
+
+    if (!startPin || !startPin->IsLive() || !endPin || !endPin->IsLive())
+        return false;
+
+    startPin->MarkConnected();
+      endPin->MarkConnected();
+
+    auto link           = GetLink(id);
+    if (link->m_StartPin != startPin || link->m_EndPin != endPin)
+    {
+        DetachLink(link);
+        link->m_StartPin  = startPin;
+        link->m_EndPin    = endPin;
+        AttachLink(link);
+    }
+    link->m_Color         = color;
+    link->m_Thickness     = thickness;
+    link->SetLive(true);
+
+    if (link->UpdateEndpoints())
+        UpdateLinkIndex(link);
+
+    return true;
+}
+
+void ed::EditorContext::SetNodePosition(NodeId nodeId, const ImVec2& position)
+{
+    SetNodePositions(&nodeId, &position, 1);
+}
+
+void ed::EditorContext::SetNodePositions(const NodeId* nodeIds, const ImVec2* positions, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        auto& position = positions[i];
+
+        auto node = FindNode(nodeIds[i]);
+        if (!node)
+        {
+            node = CreateNode(nodeIds[i]);
+            node->SetLive(false);
+        }
+
+        if (node->m_Bounds.Min != position)
+        {
+            node->m_Bounds.Translate(position - node->m_Bounds.Min);
+            node->m_Bounds.Floor();
+            UpdateNodeIndex(node);
+            MakeDirty(NodeEditor::SaveReasonFlags::Position, node);
+        }
+    }
+}
+
+ImVec2 ed::EditorContext::GetNodePosition(NodeId nodeId)
+{
+    auto node = FindNode(nodeId);
+    if (!node)
+        return ImVec2(FLT_MAX, FLT_MAX);
+
+    return node->m_Bounds.Min;
+}
+
+bool ed::EditorContext::IsNodeVisible(NodeId nodeId)
+{
+    auto node = FindNode(nodeId);
+    if (!node)
+        return true;
+
+    return IsNodeVisible(node);
+}
+
+bool ed::EditorContext::IsNodeVisible(Node* node)
+{
+    // Pins keep position from last layout until node content is submitted again.
+    const auto pinOffset = node->m_HasLayout ? node->m_Bounds.Min - node->m_LayoutPosition : ImVec2(0, 0);
+
+    return GetViewRect().Overlaps(GetNodeDrawBounds(node, GetNodeDrawMargin(), pinOffset));
+}
+
+float ed::EditorContext::GetNodeDrawMargin() const
+{
+    // Selection and hover borders, pins and anti-aliased fringe may spill outside of node.
+    const auto& editorStyle = m_Style;
+    return ImMax(ImMax(editorStyle.NodeBorderWidth, editorStyle.PinBorderWidth), ImMax(editorStyle.HoveredNodeBorderWidth, editorStyle.SelectedNodeBorderWidth))
+        + 2.0f * GetView().InvScale;
+}
+
+ImRect ed::EditorContext::GetNodeDrawBounds(Node* node, float margin, const ImVec2& pinOffset) const
+{
+    auto bounds = node->m_Bounds;
+    if (IsGroup(node))
+        bounds.Add(node->m_GroupBounds);
+
+    for (auto pin = node->m_LastPin; pin; pin = pin->m_PreviousPin)
+    {
+        auto pinBounds = pin->m_Bounds;
+        pinBounds.Translate(pinOffset);
+        bounds.Add(pinBounds);
+    }
+
+    bounds.Expand(ImMax(margin, node->m_BorderWidth + 2.0f * GetView().InvScale));
+
+    return bounds;
+}
+
+ed::LevelOfDetail ed::EditorContext::GetLevelOfDetail() const
+{
+    const auto scale = m_Canvas.ViewScale();
+
+    if (scale < m_Style.LodCoarseScale)
+        return LevelOfDetail::Coarse;
+    else if (scale < m_Style.LodReducedScale)
+        return LevelOfDetail::Reduced;
+    else
+        return LevelOfDetail::Full;
+}
+
+ImVec2 ed::EditorContext::GetNodeSize(NodeId nodeId)
+{
+    auto node = FindNode(nodeId);
+    if (!node)
+        return ImVec2(0, 0);
+
+    return node->m_Bounds.GetSize();
+}
+
+void ed::EditorContext::MarkNodeToRestoreState(Node* node)
+{
+    node->m_RestoreState = true;
+}
+
+void ed::EditorContext::RestoreNodeState(Node* node)
+{
+    auto settings = m_Settings.FindNode(node->m_ID);
+    if (!settings)
+        return;
+
+    // Load state from config (if possible)
+    if (!NodeSettings::Parse(m_Config.LoadNode(node->m_ID), *settings))
+        return;
+
+    node->m_Bounds.Min      = settings->m_Location;
+    node->m_Bounds.Max      = node->m_Bounds.Min + settings->m_Size;
+    node->m_Bounds.Floor();
+    UpdateNodeIndex(node);
+    node->m_GroupBounds.Min = settings->m_Location;
+    node->m_GroupBounds.Max = node->m_GroupBounds.Min + settings->m_GroupSize;
+    node->m_GroupBounds.Floor();
+    MarkGroupTreeDirty(node);
+    if (IsGroup(node))
+        UpdateNodeOrder(node);
+}
+
+void ed::EditorContext::ClearSelection()
+{
+    if (m_SelectedObjects.empty())
+        return;
+
+    for (auto object : m_SelectedObjects)
+    {
+        object->m_IsSelected = false;
+        MarkSelectionChanged(object);
+    }
+
+    m_SelectedObjects.clear();
+    ++m_SelectionId;
+}
+
+void ed::EditorContext::SelectObject(Object* object)
+{
+    if (object->m_IsSelected)
+        return;
+
+    object->m_IsSelected = true;
+    MarkSelectionChanged(object);
+
+    m_SelectedObjects.push_back(object);
+    ++m_SelectionId;
+}
+
+void ed::EditorContext::DeselectObject(Object* object)
+{
+    if (!object->m_IsSelected)
+        return;
+
+    object->m_IsSelected = false;
+    MarkSelectionChanged(object);
+
+    m_SelectedObjects.erase(std::find(m_SelectedObjects.begin(), m_SelectedObjects.end(), object));
+    ++m_SelectionId;
+}
+
+void ed::EditorContext::SelectObjects(Object* const* objects, int count, bool append)
+{
+    // Grow geometrically, exact reserve on every call turns repeated appends quadratic.
+    const auto required = (append ? m_SelectedObjects.size() : 0) + static_cast<size_t>(count);
+    if (required > m_SelectedObjects.capacity())
+        m_SelectedObjects.reserve(ImMax(required, m_SelectedObjects.capacity() * 2));
+
+    if (append)
+    {
+        for (int i = 0; i < count; ++i)
+            SelectObject(objects[i]);
+        return;
+    }
+
+    // Replacing selection with the very same set of objects is not a change.
+    const auto lastSelectionId   = m_SelectionId;
+    const auto lastSelectionSize = m_SelectedObjects.size();
+    const auto isSameSelection   = std::all_of(objects, objects + count, [](Object* object)
+    {
+        return object->m_IsSelected;
+    });
+
+    ClearSelection();
+    for (int i = 0; i < count; ++i)
+        SelectObject(objects[i]);
+
+    if (isSameSelection && m_SelectedObjects.size() == lastSelectionSize)
+        m_SelectionId = lastSelectionId;
+}
+
+void ed::EditorContext::DeselectObjects(const vector<Object*>& objects)
+{
+    bool anyDeselected = false;
+    for (auto object : objects)
+    {
+        if (!object->m_IsSelected)
+            continue;
+
+        object->m_IsSelected = false;
+        MarkSelectionChanged(object);
+        anyDeselected = true;
+    }
+
+    if (!anyDeselected)
+        return;
+
+    m_SelectedObjects.erase(std::remove_if(m_SelectedObjects.begin(), m_SelectedObjects.end(), [](Object* object)
+    {
+        return !object->m_IsSelected;
+    }), m_SelectedObjects.end());
+    ++m_SelectionId;
+}
+
+void ed::EditorContext::SetSelectedObject(Object* object)
+{
+    if (m_SelectedObjects.size() == 1 && m_SelectedObjects.back() == object)
+        return;
+
+    ClearSelection();
+    SelectObject(object);
+}
+
+void ed::EditorContext::ToggleObjectSelection(Object* object)
+{
+    if (IsSelected(object))
+        DeselectObject(object);
+    else
+        SelectObject(object);
+}
+
+bool ed::EditorContext::IsSelected(Object* object)
+{
+    return object && object->m_IsSelected;
+}
+
+const ed::vector<ed::Object*>& ed::EditorContext::GetSelectedObjects()
+{
+    return m_SelectedObjects;
+}
+
+bool ed::EditorContext::IsAnyNodeSelected()
+{
+    for (auto object : m_SelectedObjects)
+        if (object->AsNode())
+            return true;
+
+    return false;
+}
+
+bool ed::EditorContext::IsAnyLinkSelected()
+{
+    for (auto object : m_SelectedObjects)
+        if (object->AsLink())
+            return true;
+
+    return false;
+}
+
+bool ed::EditorContext::HasSelectionChanged()
+{
+    return m_SelectionId != m_LastSelectionId;
+}
+
+void ed::EditorContext::MarkSelectionChanged(Object* object)
+{
+    if (object->m_IsSelectionChanged)
+        return;
+
+    object->m_IsSelectionChanged = true;
+    m_SelectionChanges.push_back(object);
+}
 
-    drawList->ChannelsMerge();
+// Adjacency lists are intrusive doubly linked lists of links, 'getEntry' returns
+// siblings of link in list starting at 'head'.
+template <typename GetEntry>
+static void InsertAdjacentLink(ed::Link*& head, ed::Link* link, GetEntry&& getEntry)
+{
+    auto& entry = getEntry(link);
+    entry.m_Prev = nullptr;
+    entry.m_Next = head;
+    if (head)
+        getEntry(head).m_Prev = link;
+    head = link;
+}
 
-    // #debug
-    // drawList->AddRectFilled(ImVec2(-10.0f, -10.0f), ImVec2(10.0f, 10.0f), IM_COL32(255, 0, 255, 255));
+template <typename GetEntry>
+static void RemoveAdjacentLink(ed::Link*& head, ed::Link* link, GetEntry&& getEntry)
+{
+    auto& entry = getEntry(link);
+    if (entry.m_Prev)
+        getEntry(entry.m_Prev).m_Next = entry.m_Next;
+    else if (head == link)
+        head = entry.m_Next;
+    else
+        return; // not attached
 
-    // ImGui::EndChild();
-    // ImGui::PopStyleColor();
-    if (m_IsCanvasVisible)
-        m_Canvas.End();
+    if (entry.m_Next)
+        getEntry(entry.m_Next).m_Prev = entry.m_Prev;
 
-    ImDrawList_SwapSplitter(drawList, m_Splitter);
+    entry.m_Prev = nullptr;
+    entry.m_Next = nullptr;
+}
 
-    // Draw border
+void ed::EditorContext::AttachLink(Link* link)
+{
+    auto attach = [link](Pin* pin)
     {
-        auto& style = ImGui::GetStyle();
-        auto borderShadoColor = style.Colors[ImGuiCol_BorderShadow];
-        auto borderColor = style.Colors[ImGuiCol_Border];
-        drawList->AddRect(m_Canvas.Rect().Min + ImVec2(1, 1), m_Canvas.Rect().Max - ImVec2(1, 1), ImColor(borderShadoColor));
-        drawList->AddRect(m_Canvas.Rect().Min, m_Canvas.Rect().Max, ImColor(borderColor));
-    }
+        InsertAdjacentLink(pin->m_FirstLink, link, [pin](Link* item) -> Link::AdjacencyEntry& { return item->GetPinEntry(pin); });
+    };
 
-    // ShowMetrics(control);
+    attach(link->m_StartPin);
+    if (link->m_EndPin != link->m_StartPin)
+        attach(link->m_EndPin);
 
-    ImGui::PopID();
+    AttachLinkToNodes(link);
+}
 
-    if (!m_CurrentAction && m_IsFirstFrame && !m_Settings.m_Selection.empty())
+void ed::EditorContext::DetachLink(Link* link)
+{
+    auto detach = [link](Pin* pin)
     {
-        ClearSelection();
-        for (auto id : m_Settings.m_Selection)
-            if (auto object = FindObject(id))
-                SelectObject(object);
-    }
+        if (!pin)
+            return;
 
-    if (HasSelectionChanged())
-        MakeDirty(SaveReasonFlags::Selection);
+        RemoveAdjacentLink(pin->m_FirstLink, link, [pin](Link* item) -> Link::AdjacencyEntry& { return item->GetPinEntry(pin); });
+    };
 
-    if (m_Settings.m_IsDirty && !m_CurrentAction)
-        SaveSettings();
+    DetachLinkFromNodes(link);
 
-    m_IsFirstFrame = false;
+    detach(link->m_StartPin);
+    if (link->m_EndPin != link->m_StartPin)
+        detach(link->m_EndPin);
 }
 
-bool ed::EditorContext::DoLink(LinkId id, PinId startPinId, PinId endPinId, ImU32 color, float thickness)
+void ed::EditorContext::AttachLinkToNodes(Link* link)
 {
-    //auto& editorStyle = GetStyle();
-
-    auto startPin = FindPin(startPinId);
-    auto endPin   = FindPin(endPinId);
-
-    if (!startPin || !startPin->m_IsLive || !endPin || !endPin->m_IsLive)
-        return false;
-
-    startPin->m_HasConnection = true;
-      endPin->m_HasConnection = true;
+    IM_ASSERT(link->m_StartNode == nullptr && link->m_EndNode == nullptr);
 
-    auto link           = GetLink(id);
-    link->m_StartPin      = startPin;
-    link->m_EndPin        = endPin;
-    link->m_Color         = color;
-    link->m_Thickness     = thickness;
-    link->m_IsLive        = true;
+    auto startNode = link->m_StartPin ? link->m_StartPin->m_Node : nullptr;
+    auto endNode   = link->m_EndPin   ? link->m_EndPin->m_Node   : nullptr;
+    if (endNode == startNode)
+        endNode = nullptr;
 
-    link->UpdateEndpoints();
+    link->m_StartNode = startNode;
+    link->m_EndNode   = endNode;
 
-    return true;
+    for (auto node : { startNode, endNode })
+        if (node)
+            InsertAdjacentLink(node->m_FirstLink, link, [node](Link* item) -> Link::AdjacencyEntry& { return item->GetNodeEntry(node); });
 }
 
-void ed::EditorContext::SetNodePosition(NodeId nodeId, const ImVec2& position)
+void ed::EditorContext::DetachLinkFromNodes(Link* link)
 {
-    auto node = FindNode(nodeId);
-    if (!node)
-    {
-        node = CreateNode(nodeId);
-        node->m_IsLive = false;
-    }
+    for (auto node : { link->m_StartNode, link->m_EndNode })
+        if (node)
+            RemoveAdjacentLink(node->m_FirstLink, link, [node](Link* item) -> Link::AdjacencyEntry& { return item->GetNodeEntry(node); });
 
-    if (node->m_Bounds.Min != position)
-    {
-        node->m_Bounds.Translate(position - node->m_Bounds.Min);
-        node->m_Bounds.Floor();
-        MakeDirty(NodeEditor::SaveReasonFlags::Position, node);
-    }
+    link->m_StartNode = nullptr;
+    link->m_EndNode   = nullptr;
 }
 
-ImVec2 ed::EditorContext::GetNodePosition(NodeId nodeId)
+void ed::EditorContext::SetPinNode(Pin* pin, Node* node)
 {
-    auto node = FindNode(nodeId);
-    if (!node)
-        return ImVec2(FLT_MAX, FLT_MAX);
+    if (pin->m_Node == node)
+        return;
 
-    return node->m_Bounds.Min;
+    for (auto link = pin->m_FirstLink; link; link = link->NextLink(pin))
+        DetachLinkFromNodes(link);
+
+    pin->m_Node = node;
+
+    for (auto link = pin->m_FirstLink; link; link = link->NextLink(pin))
+        AttachLinkToNodes(link);
 }
 
-ImVec2 ed::EditorContext::GetNodeSize(NodeId nodeId)
+void ed::EditorContext::UpdateNodeIndex(Node* node)
 {
-    auto node = FindNode(nodeId);
-    if (!node)
-        return ImVec2(0, 0);
-
-    return node->m_Bounds.GetSize();
+    m_NodeIndex.Update(node, node->m_Bounds);
+    m_NodeStates.SetBounds(node->m_StateIndex, node->m_Bounds);
+    MarkGroupTreeDirty(node);
 }
 
-void ed::EditorContext::MarkNodeToRestoreState(Node* node)
+void ed::EditorContext::UpdateLinkIndex(Link* link)
 {
-    node->m_RestoreState = true;
+    m_LinkIndex.Update(link, link->m_CurveBounds);
+    m_LinkStates.SetBounds(link->m_StateIndex, link->m_CurveBounds);
 }
 
-void ed::EditorContext::RestoreNodeState(Node* node)
+void ed::EditorContext::UpdateNodeOrder(Node* node)
 {
-    auto settings = m_Settings.FindNode(node->m_ID);
-    if (!settings)
-        return;
+    IM_ASSERT(m_Nodes[node->m_DrawOrder].m_Object == node);
 
-    // Load state from config (if possible)
-    if (!NodeSettings::Parse(m_Config.LoadNode(node->m_ID), *settings))
-        return;
+    const auto index   = node->m_DrawOrder;
+    const auto wrapper = m_Nodes[index];
+    m_Nodes.erase(m_Nodes.begin() + index);
 
-    node->m_Bounds.Min      = settings->m_Location;
-    node->m_Bounds.Max      = node->m_Bounds.Min + settings->m_Size;
-    node->m_Bounds.Floor();
-    node->m_GroupBounds.Min = settings->m_Location;
-    node->m_GroupBounds.Max = node->m_GroupBounds.Min + settings->m_GroupSize;
-    node->m_GroupBounds.Floor();
+    auto groupsEnd = std::partition_point(m_Nodes.begin(), m_Nodes.end(), [](Node* node) { return IsGroup(node); });
+
+    // Groups are ordered by area, larger go first. Node which stopped being
+    // a group becomes first regular node, other nodes keep their place.
+    auto target = m_Nodes.begin() + ImMax(index, static_cast<int>(groupsEnd - m_Nodes.begin()));
+    if (IsGroup(node))
+    {
+        const auto area = GetGroupOrderArea(node);
+        target = std::find_if(m_Nodes.begin(), groupsEnd, [this, area](Node* group) { return GetGroupOrderArea(group) < area; });
+    }
+
+    const auto targetIndex = static_cast<int>(target - m_Nodes.begin());
+    m_Nodes.insert(target, wrapper);
+
+    RenumberNodes(ImMin(index, targetIndex), ImMax(index, targetIndex) + 1);
 }
 
-void ed::EditorContext::ClearSelection()
+void ed::EditorContext::BringNodeToFront(Node* node)
 {
-    m_SelectedObjects.clear();
+    IM_ASSERT(!IsGroup(node) && m_Nodes[node->m_DrawOrder].m_Object == node);
+
+    const auto index     = node->m_DrawOrder;
+    const auto nodeCount = static_cast<int>(m_Nodes.size());
+    if (index == nodeCount - 1)
+        return;
+
+    std::rotate(m_Nodes.begin() + index, m_Nodes.begin() + index + 1, m_Nodes.end());
+
+    RenumberNodes(index, nodeCount);
 }
 
-void ed::EditorContext::SelectObject(Object* object)
+void ed::EditorContext::BringNodesToFront(vector<Node*>& nodes)
 {
-    m_SelectedObjects.push_back(object);
+    // Groups keep their place, regular nodes go to the end keeping relative order.
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [](Node* node) { return IsGroup(node); }), nodes.end());
+    if (nodes.empty())
+        return;
+
+    std::sort(nodes.begin(), nodes.end());
+
+    auto first = std::min_element(nodes.begin(), nodes.end(), [](Node* lhs, Node* rhs) { return lhs->m_DrawOrder < rhs->m_DrawOrder; });
+    auto index = (*first)->m_DrawOrder;
+
+    std::stable_partition(m_Nodes.begin() + index, m_Nodes.end(), [&nodes](Node* node)
+    {
+        return !std::binary_search(nodes.begin(), nodes.end(), node);
+    });
+
+    RenumberNodes(index, static_cast<int>(m_Nodes.size()));
 }
 
-void ed::EditorContext::DeselectObject(Object* object)
+float ed::EditorContext::GetGroupOrderArea(Node* node) const
 {
-    auto objectIt = std::find(m_SelectedObjects.begin(), m_SelectedObjects.end(), object);
-    if (objectIt != m_SelectedObjects.end())
-        m_SelectedObjects.erase(objectIt);
+    // Sized group keeps its place until sizing is done.
+    const auto size = node == m_SizeAction.m_SizedNode ? m_SizeAction.GetStartGroupBounds().GetSize() : node->m_GroupBounds.GetSize();
+    return size.x * size.y;
 }
 
-void ed::EditorContext::SetSelectedObject(Object* object)
+void ed::EditorContext::RenumberNodes(int first, int last)
 {
-    ClearSelection();
-    SelectObject(object);
+    for (int i = first; i < last; ++i)
+        m_Nodes[i]->m_DrawOrder = i;
 }
 
-void ed::EditorContext::ToggleObjectSelection(Object* object)
+void ed::EditorContext::MarkGroupTreeDirty(Node* node)
 {
-    if (IsSelected(object))
-        DeselectObject(object);
-    else
-        SelectObject(object);
+    if (node->m_GroupTreeDirty)
+        return;
+
+    node->m_GroupTreeDirty = true;
+    m_GroupTreeDirtyNodes.push_back(node);
 }
 
-bool ed::EditorContext::IsSelected(Object* object)
+void ed::EditorContext::UpdateGroupTree()
 {
-    return std::find(m_SelectedObjects.begin(), m_SelectedObjects.end(), object) != m_SelectedObjects.end();
+    // Spatial index of dragged nodes is updated on release, until then
+    // tree is kept as it was when drag started.
+    if (m_GroupTreeDirtyNodes.empty() || m_DragAction.m_IsActive)
+        return;
+
+    // Content of dirty group, old and new, has to be checked too. Nodes
+    // marked here are not expanded further, bounds of their groups did
+    // not change.
+    for (size_t i = 0, dirtyCount = m_GroupTreeDirtyNodes.size(); i < dirtyCount; ++i)
+    {
+        auto node = m_GroupTreeDirtyNodes[i];
+
+        for (auto child = node->m_FirstGroupChild; child; child = child->m_NextGroupSibling)
+            MarkGroupTreeDirty(child);
+
+        if (IsGroup(node) && !ImRect_IsEmpty(node->m_GroupBounds))
+        {
+            m_NodeIndex.Query(node->m_GroupBounds, m_IndexQuery);
+            for (auto object : m_IndexQuery)
+                MarkGroupTreeDirty(object->AsNode());
+        }
+    }
+
+    for (auto node : m_GroupTreeDirtyNodes)
+    {
+        node->m_GroupTreeDirty = false;
+        SetParentGroup(node, FindParentGroup(node));
+    }
+
+    m_GroupTreeDirtyNodes.resize(0);
 }
 
-const ed::vector<ed::Object*>& ed::EditorContext::GetSelectedObjects()
+ed::Node* ed::EditorContext::GetParentGroup(Node* node)
 {
-    return m_SelectedObjects;
+    UpdateGroupTree();
+
+    auto parent = node->m_GroupParent;
+    while (parent && !parent->IsLive())
+        parent = parent->m_GroupParent;
+
+    return parent;
 }
 
-bool ed::EditorContext::IsAnyNodeSelected()
+void ed::EditorContext::GetGroupChildren(Node* group, vector<Node*>& result)
 {
-    for (auto object : m_SelectedObjects)
-        if (object->AsNode())
-            return true;
+    UpdateGroupTree();
 
-    return false;
+    result.resize(0);
+    for (auto child = group->m_FirstGroupChild; child; child = child->m_NextGroupSibling)
+        if (child->IsLive())
+            result.push_back(child);
 }
 
-bool ed::EditorContext::IsAnyLinkSelected()
+ed::Node* ed::EditorContext::FindParentGroup(Node* node)
 {
-    for (auto object : m_SelectedObjects)
-        if (object->AsLink())
-            return true;
+    if (ImRect_IsEmpty(node->m_Bounds))
+        return nullptr;
 
-    return false;
+    auto area = [](const ImRect& rect) { return rect.GetWidth() * rect.GetHeight(); };
+
+    // Group can be nested only in a larger one, on tie draw order decides.
+    // This keeps tree free of cycles.
+    auto isLarger = [&area](Node* lhs, Node* rhs)
+    {
+        const auto lhsArea = area(lhs->m_GroupBounds);
+        const auto rhsArea = area(rhs->m_GroupBounds);
+        return lhsArea > rhsArea || (lhsArea == rhsArea && lhs->m_DrawOrder < rhs->m_DrawOrder);
+    };
+
+    // Group containing node covers its corner, so single cell is enough.
+    m_NodeIndex.Query(node->m_Bounds.Min, m_IndexQuery);
+
+    Node* result = nullptr;
+    for (auto object : m_IndexQuery)
+    {
+        auto group = object->AsNode();
+        if (group == node || !IsGroup(group) || !group->m_GroupBounds.Contains(node->m_Bounds))
+            continue;
+
+        if (IsGroup(node) && !isLarger(group, node))
+            continue;
+
+        if (!result || isLarger(result, group))
+            result = group;
+    }
+
+    return result;
 }
 
-bool ed::EditorContext::HasSelectionChanged()
+void ed::EditorContext::SetParentGroup(Node* node, Node* parent)
 {
-    return m_LastSelectedObjects != m_SelectedObjects;
+    if (node->m_GroupParent == parent)
+        return;
+
+    if (auto oldParent = node->m_GroupParent)
+    {
+        if (node->m_PrevGroupSibling)
+            node->m_PrevGroupSibling->m_NextGroupSibling = node->m_NextGroupSibling;
+        else
+            oldParent->m_FirstGroupChild = node->m_NextGroupSibling;
+
+        if (node->m_NextGroupSibling)
+            node->m_NextGroupSibling->m_PrevGroupSibling = node->m_PrevGroupSibling;
+    }
+
+    node->m_GroupParent      = parent;
+    node->m_PrevGroupSibling = nullptr;
+    node->m_NextGroupSibling = nullptr;
+
+    if (parent)
+    {
+        node->m_NextGroupSibling = parent->m_FirstGroupChild;
+        if (parent->m_FirstGroupChild)
+            parent->m_FirstGroupChild->m_PrevGroupSibling = node;
+        parent->m_FirstGroupChild = node;
+    }
 }
 
 ed::Node* ed::EditorContext::FindNodeAt(const ImVec2& p)
 {
-    for (auto node : m_Nodes)
-        if (node->TestHit(p))
-            return node;
+    m_NodeIndex.Query(p, m_IndexQuery);
+
+    // First hit in draw order wins.
+    Node* result = nullptr;
+    for (auto object : m_IndexQuery)
+    {
+        auto node = object->AsNode();
+        if ((!result || node->m_DrawOrder < result->m_DrawOrder) && node->TestHit(p))
+            result = node;
+    }
 
-    return nullptr;
+    return result;
 }
 
 void ed::EditorContext::FindNodesInRect(const ImRect& r, vector<Node*>& result, bool append, bool includeIntersecting)
@@ -1622,9 +2835,20 @@ void ed::EditorContext::FindNodesInRect(const ImRect& r, vector<Node*>& result,
     if (ImRect_IsEmpty(r))
         return;
 
-    for (auto node : m_Nodes)
+    m_NodeIndex.Query(r, m_IndexQuery);
+
+    const auto firstNodeIndex = result.size();
+    for (auto object : m_IndexQuery)
+    {
+        auto node = object->AsNode();
         if (node->TestHit(r, includeIntersecting))
             result.push_back(node);
+    }
+
+    std::sort(result.begin() + firstNodeIndex, result.end(), [](Node* lhs, Node* rhs)
+    {
+        return lhs->m_DrawOrder < rhs->m_DrawOrder;
+    });
 }
 
 void ed::EditorContext::FindLinksInRect(const ImRect& r, vector<Link*>& result, bool append)
@@ -1635,9 +2859,20 @@ void ed::EditorContext::FindLinksInRect(const ImRect& r, vector<Link*>& result,
     if (ImRect_IsEmpty(r))
         return;
 
-    for (auto link : m_Links)
+    m_LinkIndex.Query(r, m_IndexQuery);
+
+    const auto firstLinkIndex = result.size();
+    for (auto object : m_IndexQuery)
+    {
+        auto link = object->AsLink();
         if (link->TestHit(r))
             result.push_back(link);
+    }
+
+    std::sort(result.begin() + firstLinkIndex, result.end(), [](Link* lhs, Link* rhs)
+    {
+        return lhs->m_ID.AsPointer() < rhs->m_ID.AsPointer();
+    });
 }
 
 void ed::EditorContext::FindLinksForNode(NodeId nodeId, vector<Link*>& result, bool add)
@@ -1645,23 +2880,50 @@ void ed::EditorContext::FindLinksForNode(NodeId nodeId, vector<Link*>& result, b
     if (!add)
         result.clear();
 
-    for (auto link : m_Links)
+    auto node = FindNode(nodeId);
+    if (!node)
+        return;
+
+    const auto firstLinkIndex = result.size();
+
+    for (auto link = node->m_FirstLink; link; link = link->NextLink(node))
+        if (link->IsLive())
+            result.push_back(link);
+
+    std::sort(result.begin() + firstLinkIndex, result.end(), [](Link* lhs, Link* rhs)
     {
-        if (!link->m_IsLive)
-            continue;
+        return lhs->m_ID.AsPointer() < rhs->m_ID.AsPointer();
+    });
+}
+
+void ed::EditorContext::FindLinksForPin(PinId pinId, vector<Link*>& result, bool add)
+{
+    if (!add)
+        result.clear();
+
+    auto pin = FindPin(pinId);
+    if (!pin)
+        return;
+
+    const auto firstLinkIndex = result.size();
 
-        if (link->m_StartPin->m_Node->m_ID == nodeId || link->m_EndPin->m_Node->m_ID == nodeId)
+    for (auto link = pin->m_FirstLink; link; link = link->NextLink(pin))
+        if (link->IsLive())
             result.push_back(link);
-    }
+
+    std::sort(result.begin() + firstLinkIndex, result.end(), [](Link* lhs, Link* rhs)
+    {
+        return lhs->m_ID.AsPointer() < rhs->m_ID.AsPointer();
+    });
 }
 
 bool ed::EditorContext::PinHadAnyLinks(PinId pinId)
 {
     auto pin = FindPin(pinId);
-    if (!pin || !pin->m_IsLive)
+    if (!pin || !pin->IsLive())
         return false;
 
-    return pin->m_HasConnection || pin->m_HadConnection;
+    return pin->HasConnection() || pin->HadConnection();
 }
 
 void ed::EditorContext::NotifyLinkDeleted(Link* link)
@@ -1692,6 +2954,30 @@ void ed::EditorContext::Resume(SuspendFlags flags)
     drawList->ChannelsSetCurrent(lastChannel);
 }
 
+void ed::EditorContext::BeginScreenSpaceChannel(int channel)
+{
+    if (!m_IsCanvasVisible || !m_Canvas.TransformCallback() || IsSuspended())
+        return;
+
+    auto drawList = ImGui::GetWindowDrawList();
+    auto lastChannel = drawList->_Splitter._Current;
+    drawList->ChannelsSetCurrent(channel);
+    m_Canvas.AddScreenTransformCallback();
+    drawList->ChannelsSetCurrent(lastChannel);
+}
+
+void ed::EditorContext::EndScreenSpaceChannel(int channel)
+{
+    if (!m_IsCanvasVisible || !m_Canvas.TransformCallback() || IsSuspended())
+        return;
+
+    auto drawList = ImGui::GetWindowDrawList();
+    auto lastChannel = drawList->_Splitter._Current;
+    drawList->ChannelsSetCurrent(channel);
+    m_Canvas.AddViewTransformCallback();
+    drawList->ChannelsSetCurrent(lastChannel);
+}
+
 bool ed::EditorContext::IsSuspended()
 {
 	return m_Canvas.IsSuspended();
@@ -1705,18 +2991,25 @@ bool ed::EditorContext::IsActive()
 ed::Pin* ed::EditorContext::CreatePin(PinId id, PinKind kind)
 {
     IM_ASSERT(nullptr == FindObject(id));
-    auto pin = new Pin(this, id, kind);
-    m_Pins.push_back({id, pin});
-    std::sort(m_Pins.begin(), m_Pins.end());
+    auto pin = m_PinPool.Create(this, id, kind);
+    pin->m_States        = &m_PinStates;
+    pin->m_StateIndex    = m_PinStates.Allocate();
+    pin->m_LastLiveFrame = m_FrameIndex;
+    m_Pins.push_back({id, pin}); // pins are looked up by id only, order is not relevant
+    m_PinMap.Insert(id, pin);
     return pin;
 }
 
 ed::Node* ed::EditorContext::CreateNode(NodeId id)
 {
     IM_ASSERT(nullptr == FindObject(id));
-    auto node = new Node(this, id);
+    auto node = m_NodePool.Create(this, id);
+    node->m_States        = &m_NodeStates;
+    node->m_StateIndex    = m_NodeStates.Allocate();
+    node->m_LastLiveFrame = m_FrameIndex;
+    node->m_DrawOrder = static_cast<int>(m_Nodes.size());
     m_Nodes.push_back({id, node});
-    //std::sort(Nodes.begin(), Nodes.end());
+    m_NodeMap.Insert(id, node);
 
     auto settings = m_Settings.FindNode(id);
     if (!settings)
@@ -1731,6 +3024,7 @@ ed::Node* ed::EditorContext::CreateNode(NodeId id)
     node->m_Bounds.Min  = settings->m_Location;
     node->m_Bounds.Max  = node->m_Bounds.Min;
     node->m_Bounds.Floor();
+    UpdateNodeIndex(node);
 
     if (settings->m_GroupSize.x > 0 || settings->m_GroupSize.y > 0)
     {
@@ -1738,9 +3032,11 @@ ed::Node* ed::EditorContext::CreateNode(NodeId id)
         node->m_GroupBounds.Min = settings->m_Location;
         node->m_GroupBounds.Max = node->m_GroupBounds.Min + settings->m_GroupSize;
         node->m_GroupBounds.Floor();
+
+        UpdateNodeOrder(node);
     }
 
-    node->m_IsLive = false;
+    node->SetLive(false);
 
     return node;
 }
@@ -1748,68 +3044,42 @@ ed::Node* ed::EditorContext::CreateNode(NodeId id)
 ed::Link* ed::EditorContext::CreateLink(LinkId id)
 {
     IM_ASSERT(nullptr == FindObject(id));
-    auto link = new Link(this, id);
-    m_Links.push_back({id, link});
-    std::sort(m_Links.begin(), m_Links.end());
+    auto link = m_LinkPool.Create(this, id);
+    link->m_States        = &m_LinkStates;
+    link->m_StateIndex    = m_LinkStates.Allocate();
+    link->m_LastLiveFrame = m_FrameIndex;
+    m_Links.push_back({id, link}); // sorted lazily by SortLinks()
+    m_LinkMap.Insert(id, link);
 
     return link;
 }
 
-template <typename C, typename Id>
-static inline auto FindItemInLinear(C& container, Id id)
+void ed::EditorContext::SortLinks()
 {
-# if defined(_DEBUG)
-    auto start = container.data();
-    auto end   = container.data() + container.size();
-    for (auto it = start; it < end; ++it)
-        if ((*it).m_ID == id)
-            return it->m_Object;
-# else
-    for (auto item : container)
-        if (item.m_ID == id)
-            return item.m_Object;
-# endif
+    if (m_SortedLinkCount == static_cast<int>(m_Links.size()))
+        return;
 
-   return static_cast<decltype(container[0].m_Object)>(nullptr);
-}
-
-template <typename C, typename Id>
-static inline auto FindItemIn(C& container, Id id)
-{
-//# if defined(_DEBUG)
-//    auto start = container.data();
-//    auto end   = container.data() + container.size();
-//    for (auto it = start; it < end; ++it)
-//        if ((*it)->ID == id)
-//            return *it;
-//# else
-//    for (auto item : container)
-//        if (item->ID == id)
-//            return item;
-//# endif
-    auto key = typename C::value_type{ id, nullptr };
-    auto first = container.cbegin();
-    auto last  = container.cend();
-    auto it    = std::lower_bound(first, last, key);
-    if (it != last && (key.m_ID == it->m_ID))
-        return it->m_Object;
-    else
-        return static_cast<decltype(it->m_Object)>(nullptr);
+    // Links created since last call form unsorted tail, merge it into sorted part.
+    auto middle = m_Links.begin() + m_SortedLinkCount;
+    std::sort(middle, m_Links.end());
+    std::inplace_merge(m_Links.begin(), middle, m_Links.end());
+
+    m_SortedLinkCount = static_cast<int>(m_Links.size());
 }
 
 ed::Node* ed::EditorContext::FindNode(NodeId id)
 {
-    return FindItemInLinear(m_Nodes, id);
+    return m_NodeMap.Find(id);
 }
 
 ed::Pin* ed::EditorContext::FindPin(PinId id)
 {
-    return FindItemIn(m_Pins, id);
+    return m_PinMap.Find(id);
 }
 
 ed::Link* ed::EditorContext::FindLink(LinkId id)
 {
-    return FindItemIn(m_Links, id);
+    return m_LinkMap.Find(id);
 }
 
 ed::Object* ed::EditorContext::FindObject(ObjectId id)
@@ -1885,29 +3155,100 @@ void ed::EditorContext::SaveSettings()
     m_Settings.m_ViewScroll = m_NavigateAction.m_Scroll;
     m_Settings.m_ViewZoom   = m_NavigateAction.m_Zoom;
 
-    if (m_Config.Save(m_Settings.Serialize(), m_Settings.m_DirtyReason))
-        m_Settings.ClearDirty();
+    if (m_Config.SaveSettings || m_Config.SettingsFile)
+    {
+        if (m_Config.Save(m_Settings.Serialize(), m_Settings.m_DirtyReason))
+            m_Settings.ClearDirty();
+    }
+    else
+    {
+        // Nowhere to save whole settings. Do not serialize them every frame, but
+        // keep dirty state of nodes which failed to save through SaveNode().
+        m_Settings.m_IsDirty     = false;
+        m_Settings.m_DirtyReason = SaveReasonFlags::None;
+    }
+
+    m_Config.EndSave();
+}
+
+void ed::EditorContext::MakeDirty(SaveReasonFlags reason)
+{
+    m_Settings.MakeDirty(reason);
+}
+
+void ed::EditorContext::MakeDirty(SaveReasonFlags reason, Node* node)
+{
+    m_Settings.MakeDirty(reason, node);
+}
+
+void ed::EditorContext::BeginFrameStats()
+{
+    if (!m_Config.EnableFrameStats)
+        return;
+
+    m_FrameStats      = FrameStats();
+    m_FrameStatsStart = Clock::now();
+    m_FrameStatsLap   = m_FrameStatsStart;
+
+    m_FrameStatsScratchGrowthCount = m_Scratch.GetGrowthCount();
+}
+
+void ed::EditorContext::RecordFrameStat(float FrameStats::* phase)
+{
+    if (!m_Config.EnableFrameStats)
+        return;
 
-    m_Config.EndSave();
+    const auto now = Clock::now();
+    if (phase)
+        m_FrameStats.*phase += std::chrono::duration<float, std::milli>(now - m_FrameStatsLap).count();
+    m_FrameStatsLap = now;
 }
 
-void ed::EditorContext::MakeDirty(SaveReasonFlags reason)
+void ed::EditorContext::EndFrameStats()
 {
-    m_Settings.MakeDirty(reason);
+    if (!m_Config.EnableFrameStats)
+        return;
+
+    m_FrameStats.Total = std::chrono::duration<float, std::milli>(Clock::now() - m_FrameStatsStart).count();
+    m_FrameStats.ScratchGrowthCount = m_Scratch.GetGrowthCount() - m_FrameStatsScratchGrowthCount;
+    m_LastFrameStats   = m_FrameStats;
+
+    if (m_FrameStatsHistory.size() < c_FrameStatsHistorySize)
+        m_FrameStatsHistory.push_back(m_FrameStats);
+    else
+        m_FrameStatsHistory[m_FrameStatsHistoryNext] = m_FrameStats;
+
+    m_FrameStatsHistoryNext = (m_FrameStatsHistoryNext + 1) % c_FrameStatsHistorySize;
 }
 
-void ed::EditorContext::MakeDirty(SaveReasonFlags reason, Node* node)
+int ed::EditorContext::GetFrameStatsHistory(FrameStats* stats, int size) const
 {
-    m_Settings.MakeDirty(reason, node);
+    const auto count = ImMin(size, static_cast<int>(m_FrameStatsHistory.size()));
+    const auto first = static_cast<int>(m_FrameStatsHistory.size()) < c_FrameStatsHistorySize ? 0 : m_FrameStatsHistoryNext;
+    const auto skip  = static_cast<int>(m_FrameStatsHistory.size()) - count;
+
+    for (int i = 0; i < count; ++i)
+        stats[i] = m_FrameStatsHistory[(first + skip + i) % m_FrameStatsHistory.size()];
+
+    return count;
 }
 
 ed::Link* ed::EditorContext::FindLinkAt(const ImVec2& p)
 {
-    for (auto& link : m_Links)
-        if (link->TestHit(p, c_LinkSelectThickness))
-            return link;
+    // Query cells around the point, link is hit within select thickness of its curve.
+    const auto extent = ImVec2(c_LinkSelectThickness, c_LinkSelectThickness);
+    m_LinkIndex.Query(ImRect(p - extent, p + extent), m_IndexQuery);
+
+    // First hit in id order wins.
+    Link* result = nullptr;
+    for (auto object : m_IndexQuery)
+    {
+        auto link = object->AsLink();
+        if ((!result || link->m_ID.AsPointer() < result->m_ID.AsPointer()) && link->TestHit(p, c_LinkSelectThickness))
+            result = link;
+    }
 
-    return nullptr;
+    return result;
 }
 
 ImU32 ed::EditorContext::GetColor(StyleColor colorIndex) const
@@ -1946,6 +3287,147 @@ void ed::EditorContext::UpdateAnimations()
     }
 }
 
+void ed::EditorContext::CollectDeadObjects()
+{
+    // Objects which were live in the last frame are still flagged as such here.
+    ScratchVector<Object*> scratch(m_Scratch);
+    auto& deadObjects = *scratch;
+    auto gatherDeadObjects = [this, &deadObjects](Object* object)
+    {
+        if (object->IsLive())
+            object->m_LastLiveFrame = m_FrameIndex;
+        else if (m_FrameIndex - object->m_LastLiveFrame > m_Config.DeadObjectLifetime)
+            deadObjects.push_back(object);
+    };
+
+    for (auto node : m_Nodes) gatherDeadObjects(node);
+    for (auto pin  : m_Pins)  gatherDeadObjects(pin);
+    for (auto link : m_Links) gatherDeadObjects(link);
+
+    // Do not pull objects from under action in progress.
+    if (deadObjects.empty() || m_CurrentAction)
+        return;
+
+    std::sort(deadObjects.begin(), deadObjects.end());
+
+    // Drop all references to dead objects.
+    const auto selectionSize = m_SelectedObjects.size();
+    RemoveDeadObjects(m_SelectedObjects, deadObjects);
+    RemoveDeadObjects(m_SelectionChanges, deadObjects);
+    if (m_SelectedObjects.size() != selectionSize)
+        ++m_SelectionId; // dead objects are not reported in selection changes
+
+    if (IsDeadObject(deadObjects, m_LastActiveLink))
+        m_LastActiveLink = nullptr;
+
+    m_FlowAnimationController.ForgetObjects(deadObjects);
+
+    EditorAction* actions[] = { &m_NavigateAction, &m_SizeAction, &m_DragAction, &m_SelectAction,
+        &m_ContextMenuAction, &m_ShortcutAction, &m_CreateItemAction, &m_DeleteItemsAction };
+    for (auto action : actions)
+        action->ForgetObjects(deadObjects);
+
+    for (auto node : m_Nodes)
+        if (IsDeadObject(deadObjects, node->m_LastPin))
+            node->m_LastPin = nullptr;
+
+    // Unlink dead links and links still pointing to dead pins from adjacency lists.
+    for (auto object : deadObjects)
+    {
+        if (auto link = object->AsLink())
+            DetachLink(link);
+        else if (auto pin = object->AsPin())
+            while (pin->m_FirstLink)
+                DetachLink(pin->m_FirstLink);
+    }
+
+    // Content of dead groups has to find new parent.
+    for (auto object : deadObjects)
+    {
+        auto node = object->AsNode();
+        if (!node)
+            continue;
+
+        while (auto child = node->m_FirstGroupChild)
+        {
+            SetParentGroup(child, nullptr);
+            MarkGroupTreeDirty(child);
+        }
+
+        SetParentGroup(node, nullptr);
+    }
+    RemoveDeadObjects(m_GroupTreeDirtyNodes, deadObjects);
+
+    for (auto pin : m_Pins)
+    {
+        if (IsDeadObject(deadObjects, pin->m_Node))
+            SetPinNode(pin, nullptr);
+        if (IsDeadObject(deadObjects, pin->m_PreviousPin))
+            pin->m_PreviousPin = nullptr;
+    }
+
+    for (auto link : m_Links)
+    {
+        if (IsDeadObject(deadObjects, link->m_StartPin))
+            link->m_StartPin = nullptr;
+        if (IsDeadObject(deadObjects, link->m_EndPin))
+            link->m_EndPin = nullptr;
+    }
+
+    // Node settings outlive nodes, object will be restored from them if it come back.
+    for (auto object : deadObjects)
+    {
+        auto node = object->AsNode();
+        if (!node)
+            continue;
+
+        auto settings = m_Settings.FindNode(node->m_ID);
+        settings->m_Location = node->m_Bounds.Min;
+        settings->m_Size     = node->m_Bounds.GetSize();
+        if (IsGroup(node))
+            settings->m_GroupSize = node->m_GroupBounds.GetSize();
+
+        m_NodeIndex.Remove(node);
+    }
+
+    for (auto object : deadObjects)
+        if (auto link = object->AsLink())
+            m_LinkIndex.Remove(link);
+
+    SortLinks();
+
+    auto removeDeadItems = [&deadObjects](auto& container, auto& map, auto& pool)
+    {
+        auto endIt = std::remove_if(container.begin(), container.end(), [&deadObjects, &map, &pool](auto& item)
+        {
+            if (!IsDeadObject(deadObjects, item.m_Object))
+                return false;
+
+            map.Erase(item.m_ID);
+            item.m_Object->m_States->Free(item.m_Object->m_StateIndex);
+            pool.Destroy(item.m_Object);
+            return true;
+        });
+        container.erase(endIt, container.end());
+    };
+
+    // Nodes in front of first dead one keep their draw order.
+    const auto firstDeadNode = static_cast<int>(std::find_if(m_Nodes.begin(), m_Nodes.end(), [&deadObjects](Node* node)
+    {
+        return IsDeadObject(deadObjects, node);
+    }) - m_Nodes.begin());
+
+    removeDeadItems(m_Nodes, m_NodeMap, m_NodePool);
+    removeDeadItems(m_Pins,  m_PinMap,  m_PinPool);
+    removeDeadItems(m_Links, m_LinkMap, m_LinkPool);
+
+    m_SortedLinkCount = static_cast<int>(m_Links.size());
+
+    RenumberNodes(firstDeadNode, static_cast<int>(m_Nodes.size()));
+
+    m_ReclaimedObjectCount += static_cast<int>(deadObjects.size());
+}
+
 void ed::EditorContext::Flow(Link* link)
 {
     m_FlowAnimationController.Flow(link);
@@ -2056,14 +3538,14 @@ ed::Control ed::EditorContext::BuildControl(bool allowOffscreen)
     {
         auto node = *nodeIt;
 
-        if (!node->m_IsLive) continue;
+        if (!node->IsLive()) continue;
 
         // Check for interactions with live pins in node before
         // processing node itself. Pins does not overlap each other
         // and all are within node bounds.
         for (auto pin = node->m_LastPin; pin; pin = pin->m_PreviousPin)
         {
-            if (!pin->m_IsLive) continue;
+            if (!pin->IsLive()) continue;
 
             checkInteractionsInArea(pin->m_ID, pin->m_Bounds, pin);
         }
@@ -2190,9 +3672,9 @@ void ed::EditorContext::ShowMetrics(const Control& control)
             return "<unknown>";
     };
 
-    auto liveNodeCount  = (int)std::count_if(m_Nodes.begin(),  m_Nodes.end(),  [](Node*  node)  { return  node->m_IsLive; });
-    auto livePinCount   = (int)std::count_if(m_Pins.begin(),   m_Pins.end(),   [](Pin*   pin)   { return   pin->m_IsLive; });
-    auto liveLinkCount  = (int)std::count_if(m_Links.begin(),  m_Links.end(),  [](Link*  link)  { return  link->m_IsLive; });
+    auto liveNodeCount  = (int)std::count_if(m_Nodes.begin(),  m_Nodes.end(),  [](Node*  node)  { return  node->IsLive(); });
+    auto livePinCount   = (int)std::count_if(m_Pins.begin(),   m_Pins.end(),   [](Pin*   pin)   { return   pin->IsLive(); });
+    auto liveLinkCount  = (int)std::count_if(m_Links.begin(),  m_Links.end(),  [](Link*  link)  { return  link->IsLive(); });
 
     auto canvasRect     = m_Canvas.Rect();
     auto viewRect       = m_Canvas.ViewRect();
@@ -2209,6 +3691,10 @@ void ed::EditorContext::ShowMetrics(const Control& control)
     ImGui::Text("Live Nodes: %d", liveNodeCount);
     ImGui::Text("Live Pins: %d", livePinCount);
     ImGui::Text("Live Links: %d", liveLinkCount);
+    ImGui::Text("Reclaimed Objects: %d", m_ReclaimedObjectCount);
+    ImGui::Text("Pool Capacity: %d nodes, %d pins, %d links", m_NodePool.Capacity(), m_PinPool.Capacity(), m_LinkPool.Capacity());
+    ImGui::Text("Node Index: %d objects in %d cells", m_NodeIndex.ObjectCount(), m_NodeIndex.CellCount());
+    ImGui::Text("Link Index: %d objects in %d cells", m_LinkIndex.ObjectCount(), m_LinkIndex.CellCount());
     ImGui::Text("Hot Object: %s (%p)", getHotObjectName(), control.HotObject ? control.HotObject->ID().AsPointer() : nullptr);
     if (auto node = control.HotObject ? control.HotObject->AsNode() : nullptr)
     {
@@ -2223,6 +3709,31 @@ void ed::EditorContext::ShowMetrics(const Control& control)
     }
     ImGui::Text("Action: %s", m_CurrentAction ? m_CurrentAction->GetName() : "<none>");
     ImGui::Text("Action Is Dragging: %s", m_CurrentAction && m_CurrentAction->IsDragging() ? "Yes" : "No");
+    if (m_Config.EnableFrameStats && !m_FrameStatsHistory.empty())
+    {
+        vector<FrameStats> history(m_FrameStatsHistory.size());
+        GetFrameStatsHistory(history.data(), static_cast<int>(history.size()));
+
+        auto getTotal = [](void* data, int index) { return reinterpret_cast<FrameStats*>(data)[index].Total; };
+
+        const auto& stats = m_LastFrameStats;
+        ImGui::Text("Frame: %.3f ms", stats.Total);
+        ImGui::PlotLines("##FrameStats", getTotal, history.data(), static_cast<int>(history.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2(240, 40));
+        ImGui::Text("    Reset: %.3f ms", stats.Reset);
+        ImGui::Text("    Node Building: %.3f ms", stats.NodeBuilding);
+        ImGui::Text("    Build Control: %.3f ms", stats.BuildControl);
+        ImGui::Text("    Draw: %.3f ms", stats.Draw);
+        ImGui::Text("    Actions: %.3f ms", stats.Actions);
+        ImGui::Text("    Group Sort: %.3f ms", stats.GroupSort);
+        ImGui::Text("    Channel Reorder: %.3f ms", stats.ChannelReorder);
+        ImGui::Text("    Grid: %.3f ms", stats.Grid);
+        ImGui::Text("    Channels Merge: %.3f ms", stats.ChannelsMerge);
+        ImGui::Text("        Channels: %d -> %d", stats.ChannelCount, stats.CompactChannelCount);
+        ImGui::Text("        Draw Calls: %d -> %d", stats.DrawCallCount, stats.MergedDrawCallCount);
+        ImGui::Text("    Canvas: %.3f ms", stats.Canvas);
+        ImGui::Text("    Save Settings: %.3f ms", stats.SaveSettings);
+        ImGui::Text("Scratch Growths: %d", stats.ScratchGrowthCount);
+    }
     m_NavigateAction.ShowMetrics();
     m_SizeAction.ShowMetrics();
     m_DragAction.ShowMetrics();
@@ -2321,16 +3832,27 @@ bool ed::NodeSettings::Parse(const json::value& data, NodeSettings& result)
 ed::NodeSettings* ed::Settings::AddNode(NodeId id)
 {
     m_Nodes.push_back(NodeSettings(id));
+    SyncNodeMap();
     return &m_Nodes.back();
 }
 
 ed::NodeSettings* ed::Settings::FindNode(NodeId id)
 {
-    for (auto& settings : m_Nodes)
-        if (settings.m_ID == id)
-            return &settings;
+    SyncNodeMap();
+    return m_NodeMap.Find(id);
+}
+
+void ed::Settings::SyncNodeMap()
+{
+    if (m_NodeMapData != m_Nodes.data())
+    {
+        m_NodeMap.Clear();
+        m_NodeMapData = m_Nodes.data();
+    }
 
-    return nullptr;
+    // Settings are only ever appended, map is missing entries from the tail.
+    for (auto i = m_NodeMap.Size(), count = static_cast<int>(m_Nodes.size()); i < count; ++i)
+        m_NodeMap.Insert(m_Nodes[i].m_ID, &m_Nodes[i]);
 }
 
 void ed::Settings::ClearDirty(Node* node)
@@ -2699,7 +4221,7 @@ void ed::FlowAnimation::Draw(ImDrawList* drawList)
 
 bool ed::FlowAnimation::IsLinkValid() const
 {
-    return m_Link && m_Link->m_IsLive;
+    return m_Link && m_Link->IsLive();
 }
 
 bool ed::FlowAnimation::IsPathValid() const
@@ -2788,7 +4310,7 @@ ed::FlowAnimationController::~FlowAnimationController()
 
 void ed::FlowAnimationController::Flow(Link* link)
 {
-    if (!link || !link->m_IsLive)
+    if (!link || !link->IsLive())
         return;
 
     auto& editorStyle = GetStyle();
@@ -2838,6 +4360,18 @@ void ed::FlowAnimationController::Release(FlowAnimation* animation)
     IM_UNUSED(animation);
 }
 
+void ed::FlowAnimationController::ForgetObjects(const vector<Object*>& deadObjects)
+{
+    for (auto animation : m_Animations)
+    {
+        if (!IsDeadObject(deadObjects, animation->m_Link))
+            continue;
+
+        animation->Stop();
+        animation->m_Link = nullptr;
+    }
+}
+
 
 
 //------------------------------------------------------------------------------
@@ -3035,6 +4569,12 @@ void ed::NavigateAction::ShowMetrics()
     ImGui::Text("    Zoom: %g", m_Zoom);
 }
 
+void ed::NavigateAction::ForgetObjects(const vector<Object*>& deadObjects)
+{
+    if (IsDeadObject(deadObjects, m_LastObject))
+        m_LastObject = nullptr;
+}
+
 void ed::NavigateAction::NavigateTo(const ImRect& bounds, bool zoomIn, float duration, NavigationReason reason)
 {
     if (ImRect_IsEmpty(bounds))
@@ -3270,7 +4810,11 @@ bool ed::SizeAction::Process(const Control& control)
         if (m_SizedNode->m_Bounds.GetSize() != m_StartBounds.GetSize() || m_SizedNode->m_GroupBounds.GetSize() != m_StartGroupBounds.GetSize())
             Editor->MakeDirty(SaveReasonFlags::Size | SaveReasonFlags::User, m_SizedNode);
 
+        auto sizedNode = m_SizedNode;
         m_SizedNode = nullptr;
+
+        if (IsGroup(sizedNode))
+            Editor->UpdateNodeOrder(sizedNode);
     }
 
     if (!m_IsActive)
@@ -3310,6 +4854,8 @@ bool ed::SizeAction::Process(const Control& control)
         m_SizedNode->m_GroupBounds.Min.y -= m_StartBounds.Min.y - m_StartGroupBounds.Min.y;
         m_SizedNode->m_GroupBounds.Max.x -= m_StartBounds.Max.x - m_StartGroupBounds.Max.x;
         m_SizedNode->m_GroupBounds.Max.y -= m_StartBounds.Max.y - m_StartGroupBounds.Max.y;
+
+        Editor->UpdateNodeIndex(m_SizedNode);
     }
     else if (!control.ActiveNode)
     {
@@ -3348,6 +4894,12 @@ void ed::SizeAction::ShowMetrics()
     }
 }
 
+void ed::SizeAction::ForgetObjects(const vector<Object*>& deadObjects)
+{
+    if (IsDeadObject(deadObjects, m_SizedNode))
+        m_SizedNode = nullptr;
+}
+
 ed::NodeRegion ed::SizeAction::GetRegion(Node* node)
 {
     return node->GetRegion(ImGui::GetMousePos());
@@ -3404,38 +4956,31 @@ ed::EditorAction::AcceptResult ed::DragAction::Accept(const Control& control)
 
     if (control.ActiveObject && ImGui::IsMouseDragging(0))
     {
-        if (!control.ActiveObject->AcceptDrag())
+        m_Nodes.resize(0);
+        m_Objects.resize(0);
+
+        if (!Pick(control.ActiveObject))
             return False;
 
         m_DraggedObject = control.ActiveObject;
 
-        m_Objects.resize(0);
-        m_Objects.push_back(m_DraggedObject);
-
         if (Editor->IsSelected(m_DraggedObject))
         {
             for (auto selectedObject : Editor->GetSelectedObjects())
                 if (auto selectedNode = selectedObject->AsNode())
-                    if (selectedNode != m_DraggedObject && selectedNode->AcceptDrag())
-                        m_Objects.push_back(selectedNode);
+                    Pick(selectedNode);
         }
 
         auto& io = ImGui::GetIO();
         if (!io.KeyShift)
         {
-            std::vector<Node*> groupedNodes;
-            for (auto object : m_Objects)
-                if (auto node = object->AsNode())
-                    node->GetGroupedNodes(groupedNodes, true);
-
-            auto isAlreadyPicked = [this](Node* node)
-            {
-                return std::find(m_Objects.begin(), m_Objects.end(), node) != m_Objects.end();
-            };
+            ScratchVector<Node*> scratch(Editor->GetScratch());
+            auto& groupedNodes = *scratch;
+            for (auto node : m_Nodes)
+                node->GetGroupedNodes(groupedNodes, true);
 
             for (auto candidate : groupedNodes)
-                if (!isAlreadyPicked(candidate) && candidate->AcceptDrag())
-                    m_Objects.push_back(candidate);
+                Pick(candidate);
         }
 
         m_IsActive = true;
@@ -3454,12 +4999,21 @@ bool ed::DragAction::Process(const Control& control)
     {
         m_Clear = false;
 
+        for (auto node : m_Nodes)
+        {
+            node->m_IsDragged = false;
+            if (node->EndDrag())
+                Editor->MakeDirty(SaveReasonFlags::Position | SaveReasonFlags::User, node);
+        }
+
         for (auto object : m_Objects)
         {
+            object->m_IsDragged = false;
             if (object->EndDrag())
                 Editor->MakeDirty(SaveReasonFlags::Position | SaveReasonFlags::User, object->AsNode());
         }
 
+        m_Nodes.resize(0);
         m_Objects.resize(0);
 
         m_DraggedObject = nullptr;
@@ -3513,11 +5067,17 @@ bool ed::DragAction::Process(const Control& control)
         if (!ImGui::GetIO().KeyAlt)
             dragOffset = alignedOffset;
 
+        MoveNodes(dragOffset);
+
         for (auto object : m_Objects)
             object->UpdateDrag(dragOffset);
     }
     else if (!control.ActiveObject)
     {
+        // Spatial index and group membership were not touched while dragging.
+        for (auto node : m_Nodes)
+            Editor->UpdateNodeIndex(node);
+
         m_Clear = true;
 
         m_IsActive = false;
@@ -3545,6 +5105,44 @@ void ed::DragAction::ShowMetrics()
     ImGui::Text("    Node: %s (%p)", getObjectName(m_DraggedObject), m_DraggedObject ? m_DraggedObject->ID().AsPointer() : nullptr);
 }
 
+void ed::DragAction::ForgetObjects(const vector<Object*>& deadObjects)
+{
+    if (IsDeadObject(deadObjects, m_DraggedObject))
+        m_DraggedObject = nullptr;
+
+    RemoveDeadObjects(m_Nodes, deadObjects);
+    RemoveDeadObjects(m_Objects, deadObjects);
+}
+
+bool ed::DragAction::Pick(Object* object)
+{
+    if (object->m_IsDragged || !object->AcceptDrag())
+        return false;
+
+    object->m_IsDragged = true;
+
+    if (auto node = object->AsNode())
+        m_Nodes.push_back(node);
+    else
+        m_Objects.push_back(object);
+
+    return true;
+}
+
+// Unlike Node::UpdateDrag(), only bounds used for culling are kept current.
+// Updating spatial index and group tree for every dragged node on every
+// frame dominates dragging of large selections, so it is done once when
+// drag ends. Until then FindNodeAt() and FindNodesInRect() see dragged
+// nodes at the position drag started from.
+void ed::DragAction::MoveNodes(const ImVec2& offset)
+{
+    for (auto node : m_Nodes)
+    {
+        node->MoveToDragOffset(offset);
+        node->m_States->SetBounds(node->m_StateIndex, node->m_Bounds);
+    }
+}
+
 
 
 
@@ -3655,8 +5253,10 @@ bool ed::SelectAction::Process(const Control& control)
         if (rect.GetHeight() <= 0)
             rect.Max.y = rect.Min.y + 1;
 
-        vector<Node*> nodes;
-        vector<Link*> links;
+        ScratchVector<Node*> nodeScratch(Editor->GetScratch());
+        ScratchVector<Link*> linkScratch(Editor->GetScratch());
+        auto& nodes = *nodeScratch;
+        auto& links = *linkScratch;
 
         if (m_SelectLinkMode)
         {
@@ -3706,6 +5306,12 @@ void ed::SelectAction::ShowMetrics()
     ImGui::Text("    Active: %s", m_IsActive ? "yes" : "no");
 }
 
+void ed::SelectAction::ForgetObjects(const vector<Object*>& deadObjects)
+{
+    RemoveDeadObjects(m_CandidateObjects, deadObjects);
+    RemoveDeadObjects(m_SelectedObjectsAtStart, deadObjects);
+}
+
 void ed::SelectAction::Draw(ImDrawList* drawList)
 {
     if (!m_IsActive && !m_Animation.IsPlaying())
@@ -3918,7 +5524,8 @@ ed::EditorAction::AcceptResult ed::ShortcutAction::Accept(const Control& control
                 m_Context.assign(selection.begin(), selection.end());
 
                 // Expand groups
-                vector<Node*> extra;
+                ScratchVector<Node*> scratch(Editor->GetScratch());
+                auto& extra = *scratch;
                 for (auto object : m_Context)
                 {
                     auto node = object->AsNode();
@@ -3965,7 +5572,8 @@ ed::EditorAction::AcceptResult ed::ShortcutAction::Accept(const Control& control
                 };
 
                 // Collect links connected to nodes and drop those reaching out of context
-                std::vector<Link*> links;
+                ScratchVector<Link*> scratch(Editor->GetScratch());
+                auto& links = *scratch;
 
                 for (auto node : nodes)
                     Editor->FindLinksForNode(node.m_ID, links, true);
@@ -4035,6 +5643,11 @@ void ed::ShortcutAction::ShowMetrics()
     ImGui::Text("    Action: %s", getActionName(m_CurrentAction));
 }
 
+void ed::ShortcutAction::ForgetObjects(const vector<Object*>& deadObjects)
+{
+    RemoveDeadObjects(m_Context, deadObjects);
+}
+
 bool ed::ShortcutAction::Begin()
 {
     if (m_IsActive)
@@ -4101,7 +5714,8 @@ ed::CreateItemAction::CreateItemAction(EditorContext* editor):
     m_IsActive(false),
     m_DraggedPin(nullptr),
 
-    m_IsInGlobalSpace(false)
+    m_IsInGlobalSpace(false),
+    m_GlobalSpaceChannel(0)
 {
 }
 
@@ -4230,6 +5844,16 @@ void ed::CreateItemAction::ShowMetrics()
     ImGui::Text("    Item Type: %s", getItemName(m_ItemType));
 }
 
+void ed::CreateItemAction::ForgetObjects(const vector<Object*>& deadObjects)
+{
+    if (IsDeadObject(deadObjects, m_LinkStart))
+        m_LinkStart = nullptr;
+    if (IsDeadObject(deadObjects, m_LinkEnd))
+        m_LinkEnd = nullptr;
+    if (IsDeadObject(deadObjects, m_DraggedPin))
+        m_DraggedPin = nullptr;
+}
+
 void ed::CreateItemAction::SetStyle(ImU32 color, float thickness)
 {
     m_LinkColor     = color;
@@ -4262,6 +5886,7 @@ void ed::CreateItemAction::End()
     {
         ImGui::PopClipRect();
         Editor->Resume(SuspendFlags::KeepSplitter);
+        Editor->EndScreenSpaceChannel(m_GlobalSpaceChannel);
 
         auto currentChannel = ImGui::GetWindowDrawList()->_Splitter._Current;
         if (currentChannel != m_LastChannel)
@@ -4373,6 +5998,8 @@ ed::CreateItemAction::Result ed::CreateItemAction::QueryLink(PinId* startId, Pin
 
     if (!m_IsInGlobalSpace)
     {
+        m_GlobalSpaceChannel = ImGui::GetWindowDrawList()->_Splitter._Current;
+        Editor->BeginScreenSpaceChannel(m_GlobalSpaceChannel);
         Editor->Suspend(SuspendFlags::KeepSplitter);
 
         auto rect = Editor->GetRect();
@@ -4396,6 +6023,8 @@ ed::CreateItemAction::Result ed::CreateItemAction::QueryNode(PinId* pinId)
 
     if (!m_IsInGlobalSpace)
     {
+        m_GlobalSpaceChannel = ImGui::GetWindowDrawList()->_Splitter._Current;
+        Editor->BeginScreenSpaceChannel(m_GlobalSpaceChannel);
         Editor->Suspend(SuspendFlags::KeepSplitter);
 
         auto rect = Editor->GetRect();
@@ -4419,7 +6048,9 @@ ed::DeleteItemsAction::DeleteItemsAction(EditorContext* editor):
     m_IsActive(false),
     m_InInteraction(false),
     m_CurrentItemType(Unknown),
-    m_UserAction(Undetermined)
+    m_UserAction(Undetermined),
+    m_CandidateItemIndex(),
+    m_QueriedItemsEnd(0)
 {
 }
 
@@ -4432,7 +6063,8 @@ ed::EditorAction::AcceptResult ed::DeleteItemsAction::Accept(const Control& cont
 
     auto addDeadLinks = [this]()
     {
-        vector<ed::Link*> links;
+        ScratchVector<ed::Link*> scratch(Editor->GetScratch());
+        auto& links = *scratch;
         for (auto object : m_CandidateObjects)
         {
             auto node = object->AsNode();
@@ -4510,6 +6142,13 @@ void ed::DeleteItemsAction::ShowMetrics()
     //ImGui::Text("    Node: %s (%d)", getObjectName(DeleteItemsgedNode), DeleteItemsgedNode ? DeleteItemsgedNode->ID : 0);
 }
 
+void ed::DeleteItemsAction::ForgetObjects(const vector<Object*>& deadObjects)
+{
+    RemoveDeadObjects(m_ManuallyDeletedObjects, deadObjects);
+    RemoveDeadObjects(m_CandidateObjects, deadObjects);
+    RemoveDeadObjects(m_RemovedObjects, deadObjects);
+}
+
 bool ed::DeleteItemsAction::Add(Object* object)
 {
     if (Editor->GetCurrentAction() != nullptr)
@@ -4530,6 +6169,9 @@ bool ed::DeleteItemsAction::Begin()
 
     m_CurrentItemType = Unknown;
     m_UserAction      = Undetermined;
+    m_QueriedItemsEnd = 0;
+    for (auto& index : m_CandidateItemIndex)
+        index = 0;
 
     return m_IsActive;
 }
@@ -4541,17 +6183,16 @@ void ed::DeleteItemsAction::End()
 
     IM_ASSERT(m_InInteraction);
     m_InInteraction = false;
+
+    Editor->DeselectObjects(m_RemovedObjects);
+    m_RemovedObjects.clear();
+
+    m_CandidateObjects.erase(std::remove(m_CandidateObjects.begin(), m_CandidateObjects.end(), nullptr), m_CandidateObjects.end());
 }
 
 bool ed::DeleteItemsAction::QueryLink(LinkId* linkId, PinId* startId, PinId* endId)
 {
-    ObjectId objectId;
-    if (!QueryItem(&objectId, Link))
-        return false;
-
-    if (auto id = objectId.AsLinkId())
-        *linkId = id;
-    else
+    if (QueryLinks(linkId, 1) != 1)
         return false;
 
     if (startId || endId)
@@ -4568,96 +6209,150 @@ bool ed::DeleteItemsAction::QueryLink(LinkId* linkId, PinId* startId, PinId* end
 
 bool ed::DeleteItemsAction::QueryNode(NodeId* nodeId)
 {
-    ObjectId objectId;
-    if (!QueryItem(&objectId, Node))
-        return false;
+    return QueryNodes(nodeId, 1) == 1;
+}
+
+int ed::DeleteItemsAction::QueryLinks(LinkId* linkIds, int size)
+{
+    if (!linkIds)
+        return CountItems(Link);
+
+    auto count = QueryItems(Link, size);
+    ForEachQueriedItem([&linkIds](Object* item)
+    {
+        *linkIds++ = item->AsLink()->m_ID;
+    });
+
+    return count;
+}
+
+int ed::DeleteItemsAction::QueryNodes(NodeId* nodeIds, int size)
+{
+    if (!nodeIds)
+        return CountItems(Node);
 
-    if (auto id = objectId.AsNodeId())
-        *nodeId = id;
+    auto count = QueryItems(Node, size);
+    ForEachQueriedItem([&nodeIds](Object* item)
+    {
+        *nodeIds++ = item->AsNode()->m_ID;
+    });
+
+    return count;
+}
+
+bool ed::DeleteItemsAction::IsItemOfType(Object* item, IteratorType itemType)
+{
+    if (!item)
+        return false;
+    else if (itemType == Node)
+        return item->AsNode() != nullptr;
+    else if (itemType == Link)
+        return item->AsLink() != nullptr;
     else
         return false;
-
-    return true;
 }
 
-bool ed::DeleteItemsAction::QueryItem(ObjectId* itemId, IteratorType itemType)
+int ed::DeleteItemsAction::QueryItems(IteratorType itemType, int size)
 {
     if (!m_InInteraction)
-        return false;
+        return 0;
 
-    if (m_CurrentItemType != itemType)
-    {
-        m_CurrentItemType    = itemType;
-        m_CandidateItemIndex = 0;
-    }
-    else if (m_UserAction == Undetermined)
-    {
+    // Items left undetermined are rejected when user ask for more of the same type.
+    if (m_CurrentItemType == itemType && m_UserAction == Undetermined)
         RejectItem();
-    }
 
-    m_UserAction = Undetermined;
+    m_CurrentItemType = itemType;
+    m_UserAction      = Undetermined;
 
-    auto itemCount = (int)m_CandidateObjects.size();
-    while (m_CandidateItemIndex < itemCount)
-    {
-        auto item = m_CandidateObjects[m_CandidateItemIndex];
-        if (itemType == Node)
-        {
-            if (auto node = item->AsNode())
-            {
-                *itemId = node->m_ID;
-                return true;
-            }
-        }
-        else if (itemType == Link)
-        {
-            if (auto link = item->AsLink())
-            {
-                *itemId = link->m_ID;
-                return true;
-            }
-        }
+    auto  itemCount = (int)m_CandidateObjects.size();
+    auto& itemIndex = m_CandidateItemIndex[itemType];
+    while (itemIndex < itemCount && !IsItemOfType(m_CandidateObjects[itemIndex], itemType))
+        ++itemIndex;
 
-        ++m_CandidateItemIndex;
+    int count = 0;
+    m_QueriedItemsEnd = itemIndex;
+    while (count < size && m_QueriedItemsEnd < itemCount)
+    {
+        if (IsItemOfType(m_CandidateObjects[m_QueriedItemsEnd], itemType))
+            ++count;
+        ++m_QueriedItemsEnd;
     }
 
-    if (m_CandidateItemIndex == itemCount)
+    if (count == 0)
         m_CurrentItemType = Unknown;
 
-    return false;
+    return count;
 }
 
-bool ed::DeleteItemsAction::AcceptItem()
+int ed::DeleteItemsAction::CountItems(IteratorType itemType) const
 {
     if (!m_InInteraction)
+        return 0;
+
+    auto first = m_CandidateObjects.begin() + m_CandidateItemIndex[itemType];
+    return static_cast<int>(std::count_if(first, m_CandidateObjects.end(), [itemType](Object* item)
+    {
+        return IsItemOfType(item, itemType);
+    }));
+}
+
+template <typename F>
+void ed::DeleteItemsAction::ForEachQueriedItem(F&& callback)
+{
+    if (m_CurrentItemType == Unknown)
+        return;
+
+    for (int i = m_CandidateItemIndex[m_CurrentItemType]; i < m_QueriedItemsEnd; ++i)
+    {
+        auto item = m_CandidateObjects[i];
+        if (IsItemOfType(item, m_CurrentItemType))
+            callback(item);
+    }
+}
+
+bool ed::DeleteItemsAction::AcceptItem()
+{
+    // Nothing to accept outside of QueryDeleted*() loop or after item was already handled.
+    if (!m_InInteraction || m_CurrentItemType == Unknown)
         return false;
 
     m_UserAction = Accepted;
 
-    RemoveItem();
+    RemoveItems();
 
     return true;
 }
 
 void ed::DeleteItemsAction::RejectItem()
 {
-    if (!m_InInteraction)
+    if (!m_InInteraction || m_CurrentItemType == Unknown)
         return;
 
     m_UserAction = Rejected;
 
-    RemoveItem();
+    RemoveItems();
 }
 
-void ed::DeleteItemsAction::RemoveItem()
+void ed::DeleteItemsAction::RemoveItems()
 {
-    auto item = m_CandidateObjects[m_CandidateItemIndex];
-    m_CandidateObjects.erase(m_CandidateObjects.begin() + m_CandidateItemIndex);
+    if (m_CurrentItemType == Unknown)
+        return;
+
+    ForEachQueriedItem([this](Object* item)
+    {
+        m_RemovedObjects.push_back(item);
+
+        if (auto link = item->AsLink())
+            Editor->NotifyLinkDeleted(link);
+    });
 
-    Editor->DeselectObject(item);
+    // Processed items are compacted out by End().
+    auto& itemIndex = m_CandidateItemIndex[m_CurrentItemType];
+    for (; itemIndex < m_QueriedItemsEnd; ++itemIndex)
+        if (IsItemOfType(m_CandidateObjects[itemIndex], m_CurrentItemType))
+            m_CandidateObjects[itemIndex] = nullptr;
 
-    if (m_CurrentItemType == Link)
-        Editor->NotifyLinkDeleted(item->AsLink());
+    m_CurrentItemType = Unknown;
 }
 
 
@@ -4671,7 +6366,12 @@ void ed::DeleteItemsAction::RemoveItem()
 ed::NodeBuilder::NodeBuilder(EditorContext* editor):
     Editor(editor),
     m_CurrentNode(nullptr),
-    m_CurrentPin(nullptr)
+    m_CurrentPin(nullptr),
+    m_IsCulled(false),
+    m_IsReplayed(false),
+    m_ContentVersion(0),
+    m_ContentVertexStart(0),
+    m_ActiveIdIsAlive(0)
 {
 }
 
@@ -4681,7 +6381,7 @@ ed::NodeBuilder::~NodeBuilder()
     m_PinSplitter.ClearFreeMemory();
 }
 
-void ed::NodeBuilder::Begin(NodeId nodeId)
+bool ed::NodeBuilder::Begin(NodeId nodeId, uint64_t contentVersion)
 {
     IM_ASSERT(nullptr == m_CurrentNode);
 
@@ -4702,7 +6402,8 @@ void ed::NodeBuilder::Begin(NodeId nodeId)
         {
             if (::IsGroup(m_CurrentNode))
             {
-                std::vector<Node*> groupedNodes;
+                ScratchVector<Node*> scratch(Editor->GetScratch());
+                auto& groupedNodes = *scratch;
                 m_CurrentNode->GetGroupedNodes(groupedNodes);
                 groupedNodes.push_back(m_CurrentNode);
 
@@ -4710,6 +6411,7 @@ void ed::NodeBuilder::Begin(NodeId nodeId)
                 {
                     node->m_Bounds.Translate(ImFloor(offset));
                     node->m_GroupBounds.Translate(ImFloor(offset));
+                    Editor->UpdateNodeIndex(node);
                     Editor->MakeDirty(SaveReasonFlags::Position | SaveReasonFlags::User, node);
                 }
             }
@@ -4717,6 +6419,7 @@ void ed::NodeBuilder::Begin(NodeId nodeId)
             {
                 m_CurrentNode->m_Bounds.Translate(ImFloor(offset));
                 m_CurrentNode->m_GroupBounds.Translate(ImFloor(offset));
+                Editor->UpdateNodeIndex(m_CurrentNode);
                 Editor->MakeDirty(SaveReasonFlags::Position | SaveReasonFlags::User, m_CurrentNode);
             }
         }
@@ -4731,8 +6434,7 @@ void ed::NodeBuilder::Begin(NodeId nodeId)
 
     const auto alpha = ImGui::GetStyle().Alpha;
 
-    m_CurrentNode->m_IsLive           = true;
-    m_CurrentNode->m_LastPin          = nullptr;
+    m_CurrentNode->SetLive(true);
     m_CurrentNode->m_Color            = Editor->GetColor(StyleColor_NodeBg, alpha);
     m_CurrentNode->m_BorderColor      = Editor->GetColor(StyleColor_NodeBorder, alpha);
     m_CurrentNode->m_BorderWidth      = editorStyle.NodeBorderWidth;
@@ -4742,7 +6444,51 @@ void ed::NodeBuilder::Begin(NodeId nodeId)
     m_CurrentNode->m_GroupBorderWidth = editorStyle.GroupBorderWidth;
     m_CurrentNode->m_GroupRounding    = editorStyle.GroupRounding;
 
-    m_IsGroup = false;
+    m_IsGroup  = false;
+    m_IsCulled = Editor->GetConfig().LightweightNodes && m_CurrentNode->m_HasLayout
+        && m_CurrentNode->m_Type != NodeType::Group && !Editor->IsNodeVisible(m_CurrentNode);
+    m_IsReplayed = !m_IsCulled && m_CurrentNode->m_HasLayout && m_CurrentNode->m_Type != NodeType::Group
+        && m_CurrentNode->m_Retained.IsValid(contentVersion, Editor->GetView().Scale)
+        && !IsContentHovered();
+    m_ContentVersion = contentVersion;
+
+    if (m_IsCulled || m_IsReplayed)
+    {
+        // Node is off-screen or unchanged, reuse last layout. Pins follow node if it was moved.
+        const auto offset = m_CurrentNode->m_Bounds.Min - m_CurrentNode->m_LayoutPosition;
+
+        m_CurrentNode->m_LayoutPosition = m_CurrentNode->m_Bounds.Min;
+
+        for (auto pin = m_CurrentNode->m_LastPin; pin; pin = pin->m_PreviousPin)
+        {
+            pin->SetLive(true);
+            pin->m_Bounds.Translate(offset);
+            pin->m_Pivot.Translate(offset);
+        }
+
+        if (auto drawList = ImGui::GetWindowDrawList())
+        {
+            m_CurrentNode->m_Channel = drawList->_Splitter._Count;
+            ImDrawList_ChannelsGrow(drawList, drawList->_Splitter._Count + c_ChannelsPerNode);
+
+            if (m_IsReplayed)
+            {
+                auto&      retained = m_CurrentNode->m_Retained;
+                const auto offset   = m_CurrentNode->m_Bounds.Min - retained.m_Position;
+
+                // User may still draw background after EndNode(), replay it only if that does not happen.
+                retained.m_ReplayBackground = true;
+
+                drawList->ChannelsSetCurrent(m_CurrentNode->m_Channel + c_NodeContentChannel);
+                retained.m_Content.Replay(drawList, offset, retained.m_ClipRect);
+            }
+        }
+
+        return false;
+    }
+
+    m_CurrentNode->m_LastPin        = nullptr;
+    m_CurrentNode->m_LayoutPosition = m_CurrentNode->m_Bounds.Min;
 
     // Grow channel list and select user channel
     if (auto drawList = ImGui::GetWindowDrawList())
@@ -4753,8 +6499,13 @@ void ed::NodeBuilder::Begin(NodeId nodeId)
 
         m_Splitter.Clear();
         ImDrawList_SwapSplitter(drawList, m_Splitter);
+
+        m_ContentVertexStart = drawList->VtxBuffer.Size;
+        m_CurrentNode->m_Retained.m_ClipRect = drawList->_ClipRectStack.back();
     }
 
+    m_ActiveIdIsAlive = ImGui::GetCurrentContext()->ActiveIdIsAlive;
+
     // Begin outer group
     ImGui::BeginGroup();
 
@@ -4764,12 +6515,22 @@ void ed::NodeBuilder::Begin(NodeId nodeId)
         ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(editorStyle.NodePadding.x, editorStyle.NodePadding.y));
         ImGui::BeginGroup();
     }
+
+    return true;
 }
 
 void ed::NodeBuilder::End()
 {
     IM_ASSERT(nullptr != m_CurrentNode);
 
+    if (m_IsCulled || m_IsReplayed)
+    {
+        m_IsCulled    = false;
+        m_IsReplayed  = false;
+        m_CurrentNode = nullptr;
+        return;
+    }
+
     if (auto drawList = ImGui::GetWindowDrawList())
     {
         IM_ASSERT(drawList->_Splitter._Count == 1); // Did you forgot to call drawList->ChannelsMerge()?
@@ -4796,14 +6557,18 @@ void ed::NodeBuilder::End()
     if (m_CurrentNode->m_Bounds.GetSize() != m_NodeRect.GetSize())
     {
         m_CurrentNode->m_Bounds.Max = m_CurrentNode->m_Bounds.Min + m_NodeRect.GetSize();
+        Editor->UpdateNodeIndex(m_CurrentNode);
         Editor->MakeDirty(SaveReasonFlags::Size, m_CurrentNode);
     }
 
+    const auto wasGroup        = IsGroup(m_CurrentNode);
+    const auto lastGroupBounds = m_CurrentNode->m_GroupBounds;
+
     if (m_IsGroup)
     {
         // Groups cannot have pins. Discard them.
         for (auto pin = m_CurrentNode->m_LastPin; pin; pin = pin->m_PreviousPin)
-            pin->Reset();
+            pin->m_States->Reset(pin->m_StateIndex);
 
         m_CurrentNode->m_Type        = NodeType::Group;
         m_CurrentNode->m_GroupBounds = m_GroupBounds;
@@ -4812,6 +6577,33 @@ void ed::NodeBuilder::End()
     else
         m_CurrentNode->m_Type        = NodeType::Node;
 
+    if (wasGroup != m_IsGroup || (m_IsGroup && lastGroupBounds.GetSize() != m_GroupBounds.GetSize()))
+        Editor->UpdateNodeOrder(m_CurrentNode);
+
+    if (wasGroup != m_IsGroup || (m_IsGroup && (lastGroupBounds.Min != m_GroupBounds.Min || lastGroupBounds.Max != m_GroupBounds.Max)))
+        Editor->MarkGroupTreeDirty(m_CurrentNode);
+
+    // Capture content for replay. Items outside of clip rect are not drawn by ImGui, so only nodes
+    // fully visible are captured. Nodes user interacts with are not captured, widgets inside
+    // have to be submitted every frame to react to mouse and keyboard.
+    const auto hasActiveItem = m_ActiveIdIsAlive == 0 && ImGui::GetCurrentContext()->ActiveIdIsAlive != 0;
+
+    auto& retained = m_CurrentNode->m_Retained;
+    auto  drawList = ImGui::GetWindowDrawList();
+    if (m_ContentVersion != 0 && !m_IsGroup && drawList && !hasActiveItem && !IsContentHovered()
+        && ImRect(retained.m_ClipRect).Contains(m_NodeRect)
+        && retained.m_Content.Capture(drawList, m_ContentVertexStart))
+    {
+        retained.m_Version           = m_ContentVersion;
+        retained.m_Zoom              = Editor->GetView().Scale;
+        retained.m_Position          = m_CurrentNode->m_Bounds.Min;
+        retained.m_CaptureBackground = true;
+    }
+    else
+        retained.Clear();
+
+    m_CurrentNode->m_HasLayout = true;
+
     m_CurrentNode = nullptr;
 }
 
@@ -4820,13 +6612,14 @@ void ed::NodeBuilder::BeginPin(PinId pinId, PinKind kind)
     IM_ASSERT(nullptr != m_CurrentNode);
     IM_ASSERT(nullptr == m_CurrentPin);
     IM_ASSERT(false   == m_IsGroup);
+    IM_ASSERT(!m_IsCulled && !m_IsReplayed); // BeginNode() returned false, node content must be skipped
 
     auto& editorStyle = Editor->GetStyle();
 
     m_CurrentPin = Editor->GetPin(pinId, kind);
-    m_CurrentPin->m_Node = m_CurrentNode;
+    Editor->SetPinNode(m_CurrentPin, m_CurrentNode);
 
-    m_CurrentPin->m_IsLive      = true;
+    m_CurrentPin->SetLive(true);
     m_CurrentPin->m_Color       = Editor->GetColor(StyleColor_PinRect);
     m_CurrentPin->m_BorderColor = Editor->GetColor(StyleColor_PinRectBorder);
     m_CurrentPin->m_BorderWidth = editorStyle.PinBorderWidth;
@@ -4859,6 +6652,7 @@ void ed::NodeBuilder::BeginPin(PinId pinId, PinKind kind)
 void ed::NodeBuilder::EndPin()
 {
     IM_ASSERT(nullptr != m_CurrentPin);
+    IM_ASSERT(!m_IsCulled && !m_IsReplayed);
 
     if (auto drawList = ImGui::GetWindowDrawList())
     {
@@ -4896,6 +6690,7 @@ void ed::NodeBuilder::EndPin()
 void ed::NodeBuilder::PinRect(const ImVec2& a, const ImVec2& b)
 {
     IM_ASSERT(nullptr != m_CurrentPin);
+    IM_ASSERT(!m_IsCulled && !m_IsReplayed);
 
     m_CurrentPin->m_Bounds = ImRect(a, b);
     m_CurrentPin->m_Bounds.Floor();
@@ -4905,6 +6700,7 @@ void ed::NodeBuilder::PinRect(const ImVec2& a, const ImVec2& b)
 void ed::NodeBuilder::PinPivotRect(const ImVec2& a, const ImVec2& b)
 {
     IM_ASSERT(nullptr != m_CurrentPin);
+    IM_ASSERT(!m_IsCulled && !m_IsReplayed);
 
     m_CurrentPin->m_Pivot = ImRect(a, b);
     m_ResolvePivot      = false;
@@ -4913,6 +6709,7 @@ void ed::NodeBuilder::PinPivotRect(const ImVec2& a, const ImVec2& b)
 void ed::NodeBuilder::PinPivotSize(const ImVec2& size)
 {
     IM_ASSERT(nullptr != m_CurrentPin);
+    IM_ASSERT(!m_IsCulled && !m_IsReplayed);
 
     m_PivotSize    = size;
     m_ResolvePivot = true;
@@ -4921,6 +6718,7 @@ void ed::NodeBuilder::PinPivotSize(const ImVec2& size)
 void ed::NodeBuilder::PinPivotScale(const ImVec2& scale)
 {
     IM_ASSERT(nullptr != m_CurrentPin);
+    IM_ASSERT(!m_IsCulled && !m_IsReplayed);
 
     m_PivotScale   = scale;
     m_ResolvePivot = true;
@@ -4929,6 +6727,7 @@ void ed::NodeBuilder::PinPivotScale(const ImVec2& scale)
 void ed::NodeBuilder::PinPivotAlignment(const ImVec2& alignment)
 {
     IM_ASSERT(nullptr != m_CurrentPin);
+    IM_ASSERT(!m_IsCulled && !m_IsReplayed);
 
     m_PivotAlignment = alignment;
     m_ResolvePivot   = true;
@@ -4939,6 +6738,7 @@ void ed::NodeBuilder::Group(const ImVec2& size)
     IM_ASSERT(nullptr != m_CurrentNode);
     IM_ASSERT(nullptr == m_CurrentPin);
     IM_ASSERT(false   == m_IsGroup);
+    IM_ASSERT(!m_IsCulled && !m_IsReplayed);
 
     m_IsGroup = true;
 
@@ -4956,6 +6756,7 @@ void ed::NodeBuilder::ForceGroup(const ImVec2& size)
     IM_ASSERT(nullptr != m_CurrentNode);
     IM_ASSERT(nullptr == m_CurrentPin);
     IM_ASSERT(false   == m_IsGroup);
+    IM_ASSERT(!m_IsCulled && !m_IsReplayed);
 
     m_IsGroup = true;
     ImGui::Dummy(size);
@@ -4966,13 +6767,23 @@ void ed::NodeBuilder::ForceGroup(const ImVec2& size)
 
 ImDrawList* ed::NodeBuilder::GetUserBackgroundDrawList() const
 {
+    IM_ASSERT(!m_IsCulled && !m_IsReplayed);
+
     return GetUserBackgroundDrawList(m_CurrentNode);
 }
 
 ImDrawList* ed::NodeBuilder::GetUserBackgroundDrawList(Node* node) const
 {
-    if (node && node->m_IsLive)
+    if (node && node->IsLive())
     {
+        // User draws background again, capture it instead of replaying recorded one.
+        auto& retained = node->m_Retained;
+        if (retained.m_ReplayBackground)
+        {
+            retained.m_ReplayBackground  = false;
+            retained.m_CaptureBackground = true;
+        }
+
         auto drawList = ImGui::GetWindowDrawList();
         drawList->ChannelsSetCurrent(node->m_Channel + c_NodeUserBackgroundChannel);
         return drawList;
@@ -4981,6 +6792,19 @@ ImDrawList* ed::NodeBuilder::GetUserBackgroundDrawList(Node* node) const
         return nullptr;
 }
 
+bool ed::NodeBuilder::IsContentHovered() const
+{
+    const auto mousePos = ImGui::GetMousePos();
+    if (m_CurrentNode->m_Bounds.Contains(mousePos))
+        return true;
+
+    for (auto pin = m_CurrentNode->m_LastPin; pin; pin = pin->m_PreviousPin)
+        if (pin->m_Bounds.Contains(mousePos))
+            return true;
+
+    return false;
+}
+
 
 
 
@@ -5017,6 +6841,8 @@ bool ed::HintBuilder::Begin(NodeId nodeId)
 
     m_LastChannel = ImGui::GetWindowDrawList()->_Splitter._Current;
 
+    Editor->BeginScreenSpaceChannel(c_UserChannel_HintsBackground);
+    Editor->BeginScreenSpaceChannel(c_UserChannel_Hints);
     Editor->Suspend(SuspendFlags::KeepSplitter);
 
     const auto alpha = ImMax(0.0f, std::min(1.0f, (view.Scale - c_min_zoom) / (c_max_zoom - c_min_zoom)));
@@ -5050,6 +6876,8 @@ void ed::HintBuilder::End()
     ImGui::GetWindowDrawList()->ChannelsSetCurrent(m_LastChannel);
 
     Editor->Resume(SuspendFlags::KeepSplitter);
+    Editor->EndScreenSpaceChannel(c_UserChannel_Hints);
+    Editor->EndScreenSpaceChannel(c_UserChannel_HintsBackground);
 
     m_IsActive    = false;
     m_CurrentNode = nullptr;
@@ -5218,6 +7046,8 @@ float* ed::Style::GetVarFloatAddr(StyleVar idx)
         case StyleVar_PinArrowWidth:            return &PinArrowWidth;
         case StyleVar_GroupRounding:            return &GroupRounding;
         case StyleVar_GroupBorderWidth:         return &GroupBorderWidth;
+        case StyleVar_LodReducedScale:          return &LodReducedScale;
+        case StyleVar_LodCoarseScale:           return &LodCoarseScale;
         default:                                return nullptr;
     }
 }
@@ -61,6 +61,13 @@ struct Config
     ConfigSaveNodeSettings  SaveNodeSettings;
     ConfigLoadNodeSettings  LoadNodeSettings;
     void*                   UserPointer;
+    int                     DeadObjectLifetime; // Frames after which objects not submitted are freed, 0 to keep them forever
+    int                     NodeCapacityHint;   // Expected number of nodes, pins and links. Storage for them is reserved up front.
+    int                     PinCapacityHint;
+    int                     LinkCapacityHint;
+    bool                    LightweightNodes;   // Off-screen nodes keep their last layout, BeginNode() returns false and node content should be skipped.
+    bool                    EnableFrameStats;   // Measure time spent in editor phases, see GetFrameStats().
+    ImDrawCallback          CanvasTransformCallback; // Renderer callback applying canvas transform, vertices are left in canvas space. See ImGuiEx::Canvas::SetTransformCallback().
 
     Config()
         : SettingsFile("NodeEditor.json")
@@ -71,6 +78,59 @@ struct Config
         , SaveNodeSettings(nullptr)
         , LoadNodeSettings(nullptr)
         , UserPointer(nullptr)
+        , DeadObjectLifetime(0)
+        , NodeCapacityHint(0)
+        , PinCapacityHint(0)
+        , LinkCapacityHint(0)
+        , LightweightNodes(false)
+        , EnableFrameStats(false)
+        , CanvasTransformCallback(nullptr)
+    {
+    }
+};
+
+
+//------------------------------------------------------------------------------
+// Time spent in phases of single editor frame, in milliseconds.
+struct FrameStats
+{
+    float Total;            // Begin() to End()
+    float Reset;            // Resetting per-frame object state
+    float NodeBuilding;     // Code between Begin() and End(), including user code
+    float BuildControl;     // Hit testing and input state
+    float Draw;             // Drawing nodes, links, highlights and animations
+    float Actions;          // Accepting and processing actions
+    float GroupSort;        // Bringing nodes to front and sorting groups
+    float ChannelReorder;   // Placing draw channels in node order
+    float Grid;
+    float ChannelsMerge;
+    float Canvas;           // Canvas end, transformation of vertices to screen
+    float SaveSettings;
+
+    int   ChannelCount;         // Draw channels reserved by editor and nodes
+    int   CompactChannelCount;  // Draw channels left after batching nodes and skipping empty ones
+    int   DrawCallCount;        // Draw commands before channels are merged
+    int   MergedDrawCallCount;  // Draw commands after channels are merged
+    int   ScratchGrowthCount;   // Times editor temporary containers were created or grew, other heap allocations are not counted
+
+    FrameStats()
+        : Total(0.0f)
+        , Reset(0.0f)
+        , NodeBuilding(0.0f)
+        , BuildControl(0.0f)
+        , Draw(0.0f)
+        , Actions(0.0f)
+        , GroupSort(0.0f)
+        , ChannelReorder(0.0f)
+        , Grid(0.0f)
+        , ChannelsMerge(0.0f)
+        , Canvas(0.0f)
+        , SaveSettings(0.0f)
+        , ChannelCount(0)
+        , CompactChannelCount(0)
+        , DrawCallCount(0)
+        , MergedDrawCallCount(0)
+        , ScratchGrowthCount(0)
     {
     }
 };
@@ -84,6 +144,15 @@ enum class PinKind
 };
 
 
+//------------------------------------------------------------------------------
+enum class LevelOfDetail
+{
+    Full,       // Everything is drawn
+    Reduced,    // Corners are not rounded, links have no arrows
+    Coarse      // Nodes are flat rectangles, links are straight lines, pins are not highlighted
+};
+
+
 //------------------------------------------------------------------------------
 enum StyleColor
 {
@@ -134,6 +203,8 @@ enum StyleVar
     StyleVar_PinArrowWidth,
     StyleVar_GroupRounding,
     StyleVar_GroupBorderWidth,
+    StyleVar_LodReducedScale,
+    StyleVar_LodCoarseScale,
 
     StyleVar_Count
 };
@@ -163,9 +234,12 @@ struct Style
     float   PinArrowWidth;
     float   GroupRounding;
     float   GroupBorderWidth;
+    float   LodReducedScale;    // Canvas scale below which LevelOfDetail::Reduced is used
+    float   LodCoarseScale;     // Canvas scale below which LevelOfDetail::Coarse is used
     ImVec4  Colors[StyleColor_Count];
     ImVec2  GridSize;
     float   GridLineThickness;
+    ImTextureID GridTexture;    // Single grid cell, when set grid is drawn as textured quads. Texture must be sampled with repeat wrap mode.
 
     Style()
     {
@@ -192,8 +266,11 @@ struct Style
         PinArrowWidth           = 0.0f;
         GroupRounding           = 6.0f;
         GroupBorderWidth        = 1.0f;
+        LodReducedScale         = 0.6f;
+        LodCoarseScale          = 0.35f;
         GridSize                = ImVec2{32.0f, 32.0f};
         GridLineThickness       = 1.0f;
+        GridTexture             = nullptr;
 
         Colors[StyleColor_Bg]                 = ImColor( 60,  60,  70, 200);
         Colors[StyleColor_Grid]               = ImColor(120, 120, 120,  40);
@@ -241,7 +318,8 @@ void PopStyleVar(int count = 1);
 void Begin(const char* id, const ImVec2& size = ImVec2(0, 0));
 void End();
 
-void BeginNode(NodeId id);
+bool BeginNode(NodeId id);
+bool BeginNode(NodeId id, uint64_t contentVersion); // Replays content and node background captured with same non-zero version while node is not hovered nor holds active item, returns false if both should be skipped
 void BeginPin(PinId id, PinKind kind);
 void PinRect(const ImVec2& a, const ImVec2& b);
 void PinPivotRect(const ImVec2& a, const ImVec2& b);
@@ -283,12 +361,21 @@ bool QueryDeletedLink(LinkId* linkId, PinId* startId = nullptr, PinId* endId = n
 bool QueryDeletedNode(NodeId* nodeId);
 bool AcceptDeletedItem();
 void RejectDeletedItem();
+int  QueryDeletedLinks(LinkId* links, int size); // Batch of up to 'size' links, pass nullptr to count pending links only
+int  QueryDeletedNodes(NodeId* nodes, int size); // Batch of up to 'size' nodes, pass nullptr to count pending nodes only
+bool AcceptDeletedItems(); // Accepts whole batch from last query
+void RejectDeletedItems();
 void EndDelete();
 
 void SetNodePosition(NodeId nodeId, const ImVec2& editorPosition);
+void SetNodePositions(const NodeId* nodeIds, const ImVec2* editorPositions, int count);
 ImVec2 GetNodePosition(NodeId nodeId);
 ImVec2 GetNodeSize(NodeId nodeId);
 void CenterNodeOnScreen(NodeId nodeId);
+bool IsNodeVisible(NodeId nodeId);
+
+int    GetGroupChildren(NodeId groupId, NodeId* nodes, int size);
+NodeId GetParentGroup(NodeId nodeId);
 
 void RestoreNodeState(NodeId nodeId);
 
@@ -302,14 +389,22 @@ bool HasSelectionChanged();
 int  GetSelectedObjectCount();
 int  GetSelectedNodes(NodeId* nodes, int size);
 int  GetSelectedLinks(LinkId* links, int size);
+int  GetSelectionAddedNodes(NodeId* nodes, int size);   // Selected since Begin()
+int  GetSelectionAddedLinks(LinkId* links, int size);
+int  GetSelectionRemovedNodes(NodeId* nodes, int size); // Deselected since Begin()
+int  GetSelectionRemovedLinks(LinkId* links, int size);
 void ClearSelection();
 void SelectNode(NodeId nodeId, bool append = false);
 void SelectLink(LinkId linkId, bool append = false);
+void SelectNodes(const NodeId* nodeIds, int count, bool append = false); // Unknown ids are ignored
+void SelectLinks(const LinkId* linkIds, int count, bool append = false);
 void DeselectNode(NodeId nodeId);
 void DeselectLink(LinkId linkId);
 
 bool DeleteNode(NodeId nodeId);
 bool DeleteLink(LinkId linkId);
+int  DeleteNodes(const NodeId* nodeIds, int count); // Returns number of items queued for deletion
+int  DeleteLinks(const LinkId* linkIds, int count);
 
 void NavigateToContent(float duration = -1);
 void NavigateToSelection(bool zoomIn = false, float duration = -1);
@@ -337,6 +432,7 @@ int  GetActionContextLinks(LinkId* links, int size);
 void EndShortcut();
 
 float GetCurrentZoom();
+LevelOfDetail GetLevelOfDetail(); // At coarse levels node content may be replaced by a cheaper placeholder of the same size
 
 NodeId GetDoubleClickedNode();
 PinId GetDoubleClickedPin();
@@ -345,6 +441,13 @@ bool IsBackgroundClicked();
 bool IsBackgroundDoubleClicked();
 
 bool PinHadAnyLinks(PinId pinId);
+int GetNodeLinks(NodeId nodeId, LinkId* links, int size); // Live links attached to any pin of the node
+int GetPinLinks(PinId pinId, LinkId* links, int size);
+
+int GetReclaimedObjectCount();
+
+FrameStats GetFrameStats(); // Last completed frame, requires Config::EnableFrameStats
+int GetFrameStatsHistory(FrameStats* stats, int size); // Most recent frames, oldest first
 
 ImVec2 GetScreenSize();
 ImVec2 ScreenToCanvas(const ImVec2& pos);
@@ -118,9 +118,14 @@ void ax::NodeEditor::End()
     s_Editor->End();
 }
 
-void ax::NodeEditor::BeginNode(NodeId id)
+bool ax::NodeEditor::BeginNode(NodeId id)
 {
-    s_Editor->GetNodeBuilder().Begin(id);
+    return s_Editor->GetNodeBuilder().Begin(id);
+}
+
+bool ax::NodeEditor::BeginNode(NodeId id, uint64_t contentVersion)
+{
+    return s_Editor->GetNodeBuilder().Begin(id, contentVersion);
 }
 
 void ax::NodeEditor::BeginPin(PinId id, PinKind kind)
@@ -360,6 +365,34 @@ void ax::NodeEditor::RejectDeletedItem()
     context.RejectItem();
 }
 
+int ax::NodeEditor::QueryDeletedLinks(LinkId* links, int size)
+{
+    auto& context = s_Editor->GetItemDeleter();
+
+    return context.QueryLinks(links, size);
+}
+
+int ax::NodeEditor::QueryDeletedNodes(NodeId* nodes, int size)
+{
+    auto& context = s_Editor->GetItemDeleter();
+
+    return context.QueryNodes(nodes, size);
+}
+
+bool ax::NodeEditor::AcceptDeletedItems()
+{
+    auto& context = s_Editor->GetItemDeleter();
+
+    return context.AcceptItem();
+}
+
+void ax::NodeEditor::RejectDeletedItems()
+{
+    auto& context = s_Editor->GetItemDeleter();
+
+    context.RejectItem();
+}
+
 void ax::NodeEditor::EndDelete()
 {
     auto& context = s_Editor->GetItemDeleter();
@@ -372,6 +405,11 @@ void ax::NodeEditor::SetNodePosition(NodeId nodeId, const ImVec2& position)
     s_Editor->SetNodePosition(nodeId, position);
 }
 
+void ax::NodeEditor::SetNodePositions(const NodeId* nodeIds, const ImVec2* positions, int count)
+{
+    s_Editor->SetNodePositions(nodeIds, positions, count);
+}
+
 ImVec2 ax::NodeEditor::GetNodePosition(NodeId nodeId)
 {
     return s_Editor->GetNodePosition(nodeId);
@@ -388,6 +426,33 @@ void ax::NodeEditor::CenterNodeOnScreen(NodeId nodeId)
         node->CenterOnScreenInNextFrame();
 }
 
+bool ax::NodeEditor::IsNodeVisible(NodeId nodeId)
+{
+    return s_Editor->IsNodeVisible(nodeId);
+}
+
+int ax::NodeEditor::GetGroupChildren(NodeId groupId, NodeId* nodes, int size)
+{
+    ax::NodeEditor::Detail::ScratchVector<ax::NodeEditor::Detail::Node*> scratch(s_Editor->GetScratch());
+    auto& children = *scratch;
+    if (auto group = s_Editor->FindNode(groupId))
+        s_Editor->GetGroupChildren(group, children);
+
+    return BuildIdList(children, nodes, size, [](auto)
+    {
+        return true;
+    });
+}
+
+ax::NodeEditor::NodeId ax::NodeEditor::GetParentGroup(NodeId nodeId)
+{
+    if (auto node = s_Editor->FindNode(nodeId))
+        if (auto parent = s_Editor->GetParentGroup(node))
+            return parent->m_ID;
+
+    return 0;
+}
+
 void ax::NodeEditor::RestoreNodeState(NodeId nodeId)
 {
     if (auto node = s_Editor->FindNode(nodeId))
@@ -440,6 +505,38 @@ int ax::NodeEditor::GetSelectedLinks(LinkId* links, int size)
     });
 }
 
+int ax::NodeEditor::GetSelectionAddedNodes(NodeId* nodes, int size)
+{
+    return BuildIdList(s_Editor->GetSelectionChanges(), nodes, size, [](auto object)
+    {
+        return object->AsNode() != nullptr && object->m_IsSelected && !object->m_WasSelected;
+    });
+}
+
+int ax::NodeEditor::GetSelectionAddedLinks(LinkId* links, int size)
+{
+    return BuildIdList(s_Editor->GetSelectionChanges(), links, size, [](auto object)
+    {
+        return object->AsLink() != nullptr && object->m_IsSelected && !object->m_WasSelected;
+    });
+}
+
+int ax::NodeEditor::GetSelectionRemovedNodes(NodeId* nodes, int size)
+{
+    return BuildIdList(s_Editor->GetSelectionChanges(), nodes, size, [](auto object)
+    {
+        return object->AsNode() != nullptr && !object->m_IsSelected && object->m_WasSelected;
+    });
+}
+
+int ax::NodeEditor::GetSelectionRemovedLinks(LinkId* links, int size)
+{
+    return BuildIdList(s_Editor->GetSelectionChanges(), links, size, [](auto object)
+    {
+        return object->AsLink() != nullptr && !object->m_IsSelected && object->m_WasSelected;
+    });
+}
+
 void ax::NodeEditor::ClearSelection()
 {
     s_Editor->ClearSelection();
@@ -467,6 +564,28 @@ void ax::NodeEditor::SelectLink(LinkId linkId, bool append)
     }
 }
 
+void ax::NodeEditor::SelectNodes(const NodeId* nodeIds, int count, bool append)
+{
+    ax::NodeEditor::Detail::ScratchVector<ax::NodeEditor::Detail::Object*> scratch(s_Editor->GetScratch());
+    auto& nodes = *scratch;
+    for (int i = 0; i < count; ++i)
+        if (auto node = s_Editor->FindNode(nodeIds[i]))
+            nodes.push_back(node);
+
+    s_Editor->SelectObjects(nodes.data(), static_cast<int>(nodes.size()), append);
+}
+
+void ax::NodeEditor::SelectLinks(const LinkId* linkIds, int count, bool append)
+{
+    ax::NodeEditor::Detail::ScratchVector<ax::NodeEditor::Detail::Object*> scratch(s_Editor->GetScratch());
+    auto& links = *scratch;
+    for (int i = 0; i < count; ++i)
+        if (auto link = s_Editor->FindLink(linkIds[i]))
+            links.push_back(link);
+
+    s_Editor->SelectObjects(links.data(), static_cast<int>(links.size()), append);
+}
+
 void ax::NodeEditor::DeselectNode(NodeId nodeId)
 {
     if (auto node = s_Editor->FindNode(nodeId))
@@ -495,6 +614,30 @@ bool ax::NodeEditor::DeleteLink(LinkId linkId)
         return false;
 }
 
+int ax::NodeEditor::DeleteNodes(const NodeId* nodeIds, int count)
+{
+    auto& deleter = s_Editor->GetItemDeleter();
+
+    int added = 0;
+    for (int i = 0; i < count; ++i)
+        if (auto node = s_Editor->FindNode(nodeIds[i]))
+            added += deleter.Add(node) ? 1 : 0;
+
+    return added;
+}
+
+int ax::NodeEditor::DeleteLinks(const LinkId* linkIds, int count)
+{
+    auto& deleter = s_Editor->GetItemDeleter();
+
+    int added = 0;
+    for (int i = 0; i < count; ++i)
+        if (auto link = s_Editor->FindLink(linkIds[i]))
+            added += deleter.Add(link) ? 1 : 0;
+
+    return added;
+}
+
 void ax::NodeEditor::NavigateToContent(float duration)
 {
     s_Editor->NavigateTo(s_Editor->GetContentBounds(), true, duration);
@@ -606,6 +749,11 @@ float ax::NodeEditor::GetCurrentZoom()
     return s_Editor->GetView().InvScale;
 }
 
+ax::NodeEditor::LevelOfDetail ax::NodeEditor::GetLevelOfDetail()
+{
+    return s_Editor->GetLevelOfDetail();
+}
+
 ax::NodeEditor::NodeId ax::NodeEditor::GetDoubleClickedNode()
 {
     return s_Editor->GetDoubleClickedNode();
@@ -636,6 +784,45 @@ bool ax::NodeEditor::PinHadAnyLinks(PinId pinId)
     return s_Editor->PinHadAnyLinks(pinId);
 }
 
+int ax::NodeEditor::GetNodeLinks(NodeId nodeId, LinkId* links, int size)
+{
+    ax::NodeEditor::Detail::ScratchVector<ax::NodeEditor::Detail::Link*> scratch(s_Editor->GetScratch());
+    auto& nodeLinks = *scratch;
+    s_Editor->FindLinksForNode(nodeId, nodeLinks);
+
+    return BuildIdList(nodeLinks, links, size, [](auto)
+    {
+        return true;
+    });
+}
+
+int ax::NodeEditor::GetPinLinks(PinId pinId, LinkId* links, int size)
+{
+    ax::NodeEditor::Detail::ScratchVector<ax::NodeEditor::Detail::Link*> scratch(s_Editor->GetScratch());
+    auto& pinLinks = *scratch;
+    s_Editor->FindLinksForPin(pinId, pinLinks);
+
+    return BuildIdList(pinLinks, links, size, [](auto)
+    {
+        return true;
+    });
+}
+
+int ax::NodeEditor::GetReclaimedObjectCount()
+{
+    return s_Editor->GetReclaimedObjectCount();
+}
+
+ax::NodeEditor::FrameStats ax::NodeEditor::GetFrameStats()
+{
+    return s_Editor->GetFrameStats();
+}
+
+int ax::NodeEditor::GetFrameStatsHistory(FrameStats* stats, int size)
+{
+    return s_Editor->GetFrameStatsHistory(stats, size);
+}
+
 ImVec2 ax::NodeEditor::GetScreenSize()
 {
     return s_Editor->GetRect().GetSize();
@@ -28,6 +28,10 @@
 
 # include <vector>
 # include <string>
+# include <unordered_map>
+# include <memory>
+# include <new>
+# include <chrono>
 
 
 //------------------------------------------------------------------------------
@@ -136,6 +140,7 @@ enum class ObjectType
 };
 
 using ax::NodeEditor::PinKind;
+using ax::NodeEditor::LevelOfDetail;
 using ax::NodeEditor::StyleColor;
 using ax::NodeEditor::StyleVar;
 using ax::NodeEditor::SaveReasonFlags;
@@ -196,6 +201,83 @@ struct ObjectWrapper
     }
 };
 
+// Per-frame state of objects of one type kept in parallel arrays, so it can
+// be reset and culled without touching objects themselves.
+struct ObjectStates
+{
+    enum Flags: uint8_t
+    {
+        Live          = 1,
+        Visible       = 2,
+        HasConnection = 4,
+        HadConnection = 8
+    };
+
+    int Allocate()
+    {
+        if (!m_FreeSlots.empty())
+        {
+            auto index = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+            m_Flags[index] = Live;
+            return index;
+        }
+
+        m_Flags.push_back(Live);
+        m_Bounds.push_back(ImRect());
+        return static_cast<int>(m_Flags.size()) - 1;
+    }
+
+    void Free(int index)
+    {
+        m_Flags[index]  = 0;
+        m_Bounds[index] = ImRect();
+        m_FreeSlots.push_back(index);
+    }
+
+    bool Has(int index, Flags flag) const { return (m_Flags[index] & flag) != 0; }
+    void Set(int index, Flags flag, bool value)
+    {
+        if (value)
+            m_Flags[index] |= flag;
+        else
+            m_Flags[index] &= ~flag;
+    }
+
+    void SetBounds(int index, const ImRect& bounds) { m_Bounds[index] = bounds; }
+
+    // Start new frame: nothing is live, connections made in last frame are remembered.
+    void Reset()
+    {
+        auto flags = m_Flags.data();
+        for (int i = 0, count = static_cast<int>(m_Flags.size()); i < count; ++i)
+            flags[i] = ResetFlags(flags[i]);
+    }
+
+    void Reset(int index) { m_Flags[index] = ResetFlags(m_Flags[index]); }
+
+    // Mark live objects which bounds overlaps clip rectangle as visible.
+    void Cull(const ImRect& clipRect)
+    {
+        auto flags  = m_Flags.data();
+        auto bounds = m_Bounds.data();
+        for (int i = 0, count = static_cast<int>(m_Flags.size()); i < count; ++i)
+        {
+            const bool visible = (flags[i] & Live) && clipRect.Overlaps(bounds[i]);
+            flags[i] = visible ? (flags[i] | Visible) : (flags[i] & ~Visible);
+        }
+    }
+
+    int Size() const { return static_cast<int>(m_Flags.size()) - static_cast<int>(m_FreeSlots.size()); }
+
+private:
+    static uint8_t ResetFlags(uint8_t flags) { return (flags & (Live | HasConnection)) == (Live | HasConnection) ? HadConnection : 0; }
+
+    vector<uint8_t> m_Flags;
+    vector<ImRect>  m_Bounds;
+    vector<int>     m_FreeSlots;
+};
+
 struct Object
 {
     enum DrawFlags
@@ -212,11 +294,23 @@ struct Object
 
     EditorContext* const Editor;
 
-    bool    m_IsLive;
+    ObjectStates* m_States;     // Temporary objects have no states and are always live
+    int           m_StateIndex;
+    int           m_LastLiveFrame;
+    bool          m_IsSelected; // Mirrors presence in EditorContext selection list
+    bool          m_WasSelected;        // Selection state at the beginning of the frame
+    bool          m_IsSelectionChanged; // Present in EditorContext selection changes
+    bool          m_IsDragged;  // Present in DragAction dragged set
 
     Object(EditorContext* editor)
         : Editor(editor)
-        , m_IsLive(true)
+        , m_States(nullptr)
+        , m_StateIndex(-1)
+        , m_LastLiveFrame(0)
+        , m_IsSelected(false)
+        , m_WasSelected(false)
+        , m_IsSelectionChanged(false)
+        , m_IsDragged(false)
     {
     }
 
@@ -224,9 +318,15 @@ struct Object
 
     virtual ObjectId ID() = 0;
 
+    bool IsLive() const { return !m_States || m_States->Has(m_StateIndex, ObjectStates::Live); }
+    void SetLive(bool live) { if (m_States) m_States->Set(m_StateIndex, ObjectStates::Live, live); }
+
+    // Result of last ObjectStates::Cull().
+    bool IsCulledVisible() const { return !m_States || m_States->Has(m_StateIndex, ObjectStates::Visible); }
+
     bool IsVisible() const
     {
-        if (!m_IsLive)
+        if (!IsLive())
             return false;
 
         const auto bounds = GetBounds();
@@ -234,8 +334,6 @@ struct Object
         return ImGui::IsRectVisible(bounds.Min, bounds.Max);
     }
 
-    virtual void Reset() { m_IsLive = false; }
-
     virtual void Draw(ImDrawList* drawList, DrawFlags flags = None) = 0;
 
     virtual bool AcceptDrag() { return false; }
@@ -248,7 +346,7 @@ struct Object
 
     virtual bool TestHit(const ImVec2& point, float extraThickness = 0.0f) const
     {
-        if (!m_IsLive)
+        if (!IsLive())
             return false;
 
         auto bounds = GetBounds();
@@ -260,7 +358,7 @@ struct Object
 
     virtual bool TestHit(const ImRect& rect, bool allowIntersect = true) const
     {
-        if (!m_IsLive)
+        if (!IsLive())
             return false;
 
         const auto bounds = GetBounds();
@@ -285,6 +383,7 @@ struct Pin final: Object
     ImRect  m_Bounds;
     ImRect  m_Pivot;
     Pin*    m_PreviousPin;
+    Link*   m_FirstLink;    // Links attached to this pin, see Link::NextLink()
     ImU32   m_Color;
     ImU32   m_BorderColor;
     float   m_BorderWidth;
@@ -295,8 +394,6 @@ struct Pin final: Object
     float   m_Radius;
     float   m_ArrowSize;
     float   m_ArrowWidth;
-    bool    m_HasConnection;
-    bool    m_HadConnection;
 
     Pin(EditorContext* editor, PinId id, PinKind kind)
         : Object(editor)
@@ -305,6 +402,7 @@ struct Pin final: Object
         , m_Node(nullptr)
         , m_Bounds()
         , m_PreviousPin(nullptr)
+        , m_FirstLink(nullptr)
         , m_Color(IM_COL32_WHITE)
         , m_BorderColor(IM_COL32_BLACK)
         , m_BorderWidth(0)
@@ -315,20 +413,14 @@ struct Pin final: Object
         , m_Radius(0)
         , m_ArrowSize(0)
         , m_ArrowWidth(0)
-        , m_HasConnection(false)
-        , m_HadConnection(false)
     {
     }
 
     virtual ObjectId ID() override { return m_ID; }
 
-    virtual void Reset() override final
-    {
-        m_HadConnection = m_HasConnection && m_IsLive;
-        m_HasConnection = false;
-
-        Object::Reset();
-    }
+    bool HasConnection() const { return m_States && m_States->Has(m_StateIndex, ObjectStates::HasConnection); }
+    bool HadConnection() const { return m_States && m_States->Has(m_StateIndex, ObjectStates::HadConnection); }
+    void MarkConnected() { if (m_States) m_States->Set(m_StateIndex, ObjectStates::HasConnection, true); }
 
     virtual void Draw(ImDrawList* drawList, DrawFlags flags = None) override final;
 
@@ -365,6 +457,45 @@ inline NodeRegion operator |(NodeRegion lhs, NodeRegion rhs) { return static_cas
 inline NodeRegion operator &(NodeRegion lhs, NodeRegion rhs) { return static_cast<NodeRegion>(static_cast<uint8_t>(lhs) & static_cast<uint8_t>(rhs)); }
 
 
+// Draw commands of node content captured in one frame, to be replayed in
+// later frames instead of running user code again.
+struct RetainedContent
+{
+    struct Command
+    {
+        ImVec4      ClipRect;
+        ImTextureID TextureId;
+        int         VtxOffset;
+        int         VtxCount;
+        int         IdxOffset;  // Indices are relative to VtxOffset
+        int         IdxCount;
+    };
+
+    struct Layer
+    {
+        vector<Command>    m_Commands;
+        vector<ImDrawVert> m_Vertices;
+        vector<ImDrawIdx>  m_Indices;
+
+        void Clear();
+        bool Capture(const ImDrawList* drawList, int firstVertex);
+        void Replay(ImDrawList* drawList, const ImVec2& offset, const ImVec4& clipRect) const;
+    };
+
+    uint64_t           m_Version  = 0;
+    float              m_Zoom     = 0.0f;
+    ImVec2             m_Position;          // Node position at capture
+    ImVec4             m_ClipRect;          // Canvas clip rect at capture
+    Layer              m_Content;
+    Layer              m_Background;        // User background, drawn after EndNode()
+    bool               m_CaptureBackground = false; // Content was captured, background is captured in EditorContext::End()
+    bool               m_ReplayBackground  = false; // Content was replayed, background is replayed in EditorContext::End() unless user draws it again
+
+    bool IsValid(uint64_t version, float zoom) const { return m_Version != 0 && m_Version == version && m_Zoom == zoom; }
+
+    void Clear();
+};
+
 struct Node final: Object
 {
     using IdType = NodeId;
@@ -373,8 +504,13 @@ struct Node final: Object
     NodeType m_Type;
     ImRect   m_Bounds;
     int      m_Channel;
+    int      m_DrawOrder;
     Pin*     m_LastPin;
+    Link*    m_FirstLink;       // Links attached to any pin of this node, see Link::NextLink()
     ImVec2   m_DragStart;
+    ImVec2   m_LayoutPosition; // Position at which content was last laid out
+    bool     m_HasLayout;
+    RetainedContent m_Retained;
 
     ImU32    m_Color;
     ImU32    m_BorderColor;
@@ -387,6 +523,12 @@ struct Node final: Object
     float    m_GroupRounding;
     ImRect   m_GroupBounds;
 
+    Node*    m_GroupParent;      // Smallest group containing this node
+    Node*    m_FirstGroupChild;
+    Node*    m_PrevGroupSibling;
+    Node*    m_NextGroupSibling;
+    bool     m_GroupTreeDirty;
+
     bool     m_RestoreState;
     bool     m_CenterOnScreen;
 
@@ -396,13 +538,22 @@ struct Node final: Object
         , m_Type(NodeType::Node)
         , m_Bounds()
         , m_Channel(0)
+        , m_DrawOrder(0)
         , m_LastPin(nullptr)
+        , m_FirstLink(nullptr)
         , m_DragStart()
+        , m_LayoutPosition()
+        , m_HasLayout(false)
         , m_Color(IM_COL32_WHITE)
         , m_BorderColor(IM_COL32_BLACK)
         , m_BorderWidth(0)
         , m_Rounding(0)
         , m_GroupBounds()
+        , m_GroupParent(nullptr)
+        , m_FirstGroupChild(nullptr)
+        , m_PrevGroupSibling(nullptr)
+        , m_NextGroupSibling(nullptr)
+        , m_GroupTreeDirty(false)
         , m_RestoreState(false)
         , m_CenterOnScreen(false)
     {
@@ -413,6 +564,7 @@ struct Node final: Object
     bool AcceptDrag() override;
     void UpdateDrag(const ImVec2& offset) override;
     bool EndDrag() override; // return true, when changed
+    void MoveToDragOffset(const ImVec2& offset); // moves bounds only, spatial index is left to the caller
     ImVec2 DragStartLocation() override { return m_DragStart; }
 
     virtual bool IsSelectable() override { return true; }
@@ -436,41 +588,462 @@ struct Link final: Object
 {
     using IdType = LinkId;
 
+    // Siblings in adjacency list of one of the pins or nodes.
+    struct AdjacencyEntry
+    {
+        Link* m_Prev = nullptr;
+        Link* m_Next = nullptr;
+    };
+
     LinkId m_ID;
     Pin*   m_StartPin;
     Pin*   m_EndPin;
+    Node*  m_StartNode;         // Nodes which list this link, null if not listed. m_EndNode is
+    Node*  m_EndNode;           // also null if both pins belong to the same node.
+    AdjacencyEntry m_StartPinEntry;
+    AdjacencyEntry m_EndPinEntry;   // Unused if link starts and ends at the same pin
+    AdjacencyEntry m_StartNodeEntry;
+    AdjacencyEntry m_EndNodeEntry;  // Unused if link starts and ends at the same node
     ImU32  m_Color;
     float  m_Thickness;
     ImVec2 m_Start;
     ImVec2 m_End;
 
+    // Curve and bounds are cached by UpdateEndpoints() together with pin
+    // parameters they were built from.
+    ImCubicBezierPoints m_Curve;
+    ImRect              m_CurveBounds;
+    ImVec2              m_StartDir;
+    ImVec2              m_EndDir;
+    float               m_StartStrength;
+    float               m_EndStrength;
+    float               m_StartArrowSize;
+    float               m_EndArrowSize;
+    bool                m_IsCurveValid;
+    mutable vector<ImVec2> m_Polyline; // Flattened curve for hit testing, built on demand
+
     Link(EditorContext* editor, LinkId id)
         : Object(editor)
         , m_ID(id)
         , m_StartPin(nullptr)
         , m_EndPin(nullptr)
+        , m_StartNode(nullptr)
+        , m_EndNode(nullptr)
         , m_Color(IM_COL32_WHITE)
         , m_Thickness(1.0f)
+        , m_Curve()
+        , m_CurveBounds()
+        , m_StartDir()
+        , m_EndDir()
+        , m_StartStrength(0.0f)
+        , m_EndStrength(0.0f)
+        , m_StartArrowSize(0.0f)
+        , m_EndArrowSize(0.0f)
+        , m_IsCurveValid(false)
     {
     }
 
     virtual ObjectId ID() override { return m_ID; }
 
+    AdjacencyEntry& GetPinEntry(const Pin* pin) { return pin == m_StartPin ? m_StartPinEntry : m_EndPinEntry; }
+    AdjacencyEntry& GetNodeEntry(const Node* node) { return node == m_StartNode ? m_StartNodeEntry : m_EndNodeEntry; }
+    Link* NextLink(const Pin* pin) { return GetPinEntry(pin).m_Next; }
+    Link* NextLink(const Node* node) { return GetNodeEntry(node).m_Next; }
+
     virtual bool IsSelectable() override { return true; }
 
     virtual void Draw(ImDrawList* drawList, DrawFlags flags = None) override final;
     void Draw(ImDrawList* drawList, ImU32 color, float extraThickness = 0.0f) const;
 
-    void UpdateEndpoints();
+    bool UpdateEndpoints(); // return true, when curve changed
 
-    ImCubicBezierPoints GetCurve() const;
+    const ImCubicBezierPoints& GetCurve() const { return m_Curve; }
+    const vector<ImVec2>& GetPolyline() const;
 
     virtual bool TestHit(const ImVec2& point, float extraThickness = 0.0f) const override final;
     virtual bool TestHit(const ImRect& rect, bool allowIntersect = true) const override final;
 
-    virtual ImRect GetBounds() const override final;
+    virtual ImRect GetBounds() const override final { return IsLive() ? m_CurveBounds : ImRect(); }
 
     virtual Link* AsLink() override final { return this; }
+
+private:
+    ImCubicBezierPoints BuildCurve() const;
+    ImRect BuildCurveBounds() const;
+};
+
+// Open addressing id -> object table. Uses linear probing and backward shift
+// deletion, so lookups do not depend on draw order of the objects.
+template <typename T, typename Id = typename T::IdType>
+struct ObjectMap
+{
+    ObjectMap()
+        : m_Count(0)
+    {
+    }
+
+    int Size() const { return m_Count; }
+
+    void Clear()
+    {
+        m_Slots.clear();
+        m_Count = 0;
+    }
+
+    T* Find(Id id) const
+    {
+        if (m_Slots.empty())
+            return nullptr;
+
+        const auto key  = id.Get();
+        const auto mask = m_Slots.size() - 1;
+        for (auto index = Hash(key) & mask; m_Slots[index].m_Object; index = (index + 1) & mask)
+            if (m_Slots[index].m_Key == key)
+                return m_Slots[index].m_Object;
+
+        return nullptr;
+    }
+
+    void Insert(Id id, T* object)
+    {
+        IM_ASSERT(object != nullptr);
+
+        if ((m_Count + 1) * 2 > static_cast<int>(m_Slots.size()))
+            Rehash(m_Slots.empty() ? 64 : m_Slots.size() * 2);
+
+        const auto key  = id.Get();
+        const auto mask = m_Slots.size() - 1;
+        auto index = Hash(key) & mask;
+        for (; m_Slots[index].m_Object; index = (index + 1) & mask)
+        {
+            if (m_Slots[index].m_Key == key)
+            {
+                m_Slots[index].m_Object = object;
+                return;
+            }
+        }
+
+        m_Slots[index] = Slot{ key, object };
+        ++m_Count;
+    }
+
+    void Erase(Id id)
+    {
+        if (m_Slots.empty())
+            return;
+
+        const auto key  = id.Get();
+        const auto mask = m_Slots.size() - 1;
+        auto index = Hash(key) & mask;
+        for (; m_Slots[index].m_Object; index = (index + 1) & mask)
+            if (m_Slots[index].m_Key == key)
+                break;
+
+        if (!m_Slots[index].m_Object)
+            return;
+
+        // Shift following entries of the probe sequence back into the hole.
+        for (auto next = (index + 1) & mask; m_Slots[next].m_Object; next = (next + 1) & mask)
+        {
+            const auto home = Hash(m_Slots[next].m_Key) & mask;
+            if (((next - home) & mask) >= ((next - index) & mask))
+            {
+                m_Slots[index] = m_Slots[next];
+                index = next;
+            }
+        }
+
+        m_Slots[index] = Slot();
+        --m_Count;
+    }
+
+private:
+    struct Slot
+    {
+        uintptr_t m_Key    = 0;
+        T*        m_Object = nullptr;
+    };
+
+    static size_t Hash(uintptr_t key)
+    {
+        auto h = static_cast<uint64_t>(key);
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+
+    void Rehash(size_t capacity)
+    {
+        vector<Slot> slots(capacity);
+        std::swap(m_Slots, slots);
+        m_Count = 0;
+
+        for (auto& slot : slots)
+            if (slot.m_Object)
+                Insert(Id(slot.m_Key), slot.m_Object);
+    }
+
+    vector<Slot> m_Slots;
+    int          m_Count;
+};
+
+// Slab allocator for objects of single type. Slabs are never moved or freed
+// before pool is destroyed, so object addresses are stable. Freed slots are
+// reused before new slab is allocated.
+template <typename T>
+struct ObjectPool
+{
+    ObjectPool()
+        : m_Used(0)
+        , m_Count(0)
+        , m_Capacity(0)
+    {
+    }
+
+    ~ObjectPool()
+    {
+        IM_ASSERT(m_Count == 0); // Objects must be destroyed before pool.
+
+        for (auto& slab : m_Slabs)
+            delete[] slab.m_Slots;
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    int Size() const { return m_Count; }
+
+    int Capacity() const { return m_Capacity; }
+
+    void Reserve(int capacity)
+    {
+        const auto available = m_Capacity - m_Count;
+        if (capacity - m_Count > available)
+            AddSlab(ImMax(capacity - m_Count - available, m_Capacity));
+    }
+
+    template <typename... Args>
+    T* Create(Args&&... args)
+    {
+        void* slot = nullptr;
+        if (!m_FreeSlots.empty())
+        {
+            slot = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        }
+        else
+        {
+            // Slabs grow geometrically, every new one doubles capacity of the pool.
+            if (m_Slabs.empty() || m_Used == m_Slabs.back().m_Size)
+                AddSlab(ImMax(c_MinSlabSize, m_Capacity));
+
+            slot = &m_Slabs.back().m_Slots[m_Used++];
+        }
+
+        ++m_Count;
+
+        return new (slot) T(std::forward<Args>(args)...);
+    }
+
+    void Destroy(T* object)
+    {
+        if (!object)
+            return;
+
+        object->~T();
+        m_FreeSlots.push_back(object);
+        --m_Count;
+    }
+
+private:
+    static const int c_MinSlabSize = 64;
+
+    struct Slot
+    {
+        alignas(T) unsigned char m_Storage[sizeof(T)];
+    };
+
+    struct Slab
+    {
+        Slot* m_Slots;
+        int   m_Size;
+    };
+
+    void AddSlab(int size)
+    {
+        // Unused tail of current slab is not lost, it is handed over to free list.
+        if (!m_Slabs.empty())
+        {
+            auto& slab = m_Slabs.back();
+            for (auto i = slab.m_Size - 1; i >= m_Used; --i)
+                m_FreeSlots.push_back(&slab.m_Slots[i]);
+        }
+
+        m_Slabs.push_back(Slab{ new Slot[size], size });
+        m_Used      = 0;
+        m_Capacity += size;
+    }
+
+    vector<Slab>  m_Slabs;
+    vector<void*> m_FreeSlots;
+    int           m_Used;
+    int           m_Count;
+    int           m_Capacity;
+};
+
+// Temporary containers reused from frame to frame. Containers keep their
+// capacity, so once warmed up frame does not touch heap. Containers are
+// handed out and returned in stack order, see ScratchVector.
+struct ScratchArena
+{
+    ScratchArena()
+        : m_GrowthCount(0)
+    {
+    }
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    template <typename T>
+    vector<T>& Acquire()
+    {
+        auto& pool = GetPool(Tag<T>());
+        if (pool.m_Used == static_cast<int>(pool.m_Vectors.size()))
+        {
+            pool.m_Vectors.emplace_back(new vector<T>());
+            pool.m_Capacities.push_back(0);
+            ++m_GrowthCount;
+        }
+
+        auto& result = *pool.m_Vectors[pool.m_Used];
+        result.resize(0);
+        pool.m_Capacities[pool.m_Used] = result.capacity();
+        ++pool.m_Used;
+        return result;
+    }
+
+    template <typename T>
+    void Release(vector<T>& container)
+    {
+        auto& pool = GetPool(Tag<T>());
+        IM_ASSERT(pool.m_Used > 0 && pool.m_Vectors[pool.m_Used - 1].get() == &container); // Released out of order?
+
+        --pool.m_Used;
+        if (container.capacity() != pool.m_Capacities[pool.m_Used])
+            ++m_GrowthCount;
+    }
+
+    // Number of times scratch containers were created or grew since creation.
+    int GetGrowthCount() const { return m_GrowthCount; }
+
+private:
+    template <typename T>
+    struct Tag {};
+
+    template <typename T>
+    struct Pool
+    {
+        vector<std::unique_ptr<vector<T>>> m_Vectors;
+        vector<size_t>                     m_Capacities;
+        int                                m_Used = 0;
+    };
+
+    Pool<Node*>&   GetPool(Tag<Node*>)   { return m_Nodes;   }
+    Pool<Link*>&   GetPool(Tag<Link*>)   { return m_Links;   }
+    Pool<Object*>& GetPool(Tag<Object*>) { return m_Objects; }
+
+    Pool<Node*>   m_Nodes;
+    Pool<Link*>   m_Links;
+    Pool<Object*> m_Objects;
+    int           m_GrowthCount;
+};
+
+// Container borrowed from scratch arena for the duration of a scope.
+template <typename T>
+struct ScratchVector
+{
+    ScratchVector(ScratchArena& arena)
+        : m_Arena(arena)
+        , m_Vector(arena.Acquire<T>())
+    {
+    }
+
+    ~ScratchVector()
+    {
+        m_Arena.Release(m_Vector);
+    }
+
+    ScratchVector(const ScratchVector&) = delete;
+    ScratchVector& operator=(const ScratchVector&) = delete;
+
+    vector<T>& operator*()  { return m_Vector;  }
+    vector<T>* operator->() { return &m_Vector; }
+
+private:
+    ScratchArena& m_Arena;
+    vector<T>&    m_Vector;
+};
+
+// Uniform grid of object bounds. Objects are registered in every cell their
+// bounds touch, queries return unordered candidates without duplicates.
+struct SpatialGrid
+{
+    SpatialGrid(float cellSize = 256.0f)
+        : m_CellSize(cellSize)
+        , m_InvCellSize(1.0f / cellSize)
+    {
+    }
+
+    void Clear();
+
+    void Update(Object* object, const ImRect& bounds);
+    void Remove(Object* object);
+
+    void Query(const ImVec2& point, vector<Object*>& result) const;
+    void Query(const ImRect& rect, vector<Object*>& result) const;
+
+    int CellCount() const { return static_cast<int>(m_Cells.size()); }
+    int ObjectCount() const { return static_cast<int>(m_Entries.size()); }
+
+private:
+    struct CellRange
+    {
+        int MinX, MinY, MaxX, MaxY;
+
+        bool operator==(const CellRange& rhs) const { return MinX == rhs.MinX && MinY == rhs.MinY && MaxX == rhs.MaxX && MaxY == rhs.MaxY; }
+        bool operator!=(const CellRange& rhs) const { return !(*this == rhs); }
+    };
+
+    int       ToCell(float v) const;
+    CellRange ToCellRange(const ImRect& bounds) const;
+
+    static uint64_t CellKey(int x, int y) { return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y); }
+
+    void Insert(Object* object, const CellRange& range);
+    void Erase(Object* object, const CellRange& range);
+
+    float m_CellSize;
+    float m_InvCellSize;
+
+    std::unordered_map<uint64_t, vector<Object*>> m_Cells;
+    std::unordered_map<Object*, CellRange>         m_Entries;
+};
+
+// Splits nodes into draw batches. Nodes which draw bounds do not overlap
+// can share batch (and draw channels), overlapping nodes land in later
+// batches than nodes drawn before them.
+struct NodeBatcher
+{
+    // Returns number of batches. Bounds are given in draw order.
+    int Build(const ImRect* bounds, int count);
+
+    int Batch(int index) const { return m_Batches[index]; }
+
+private:
+    vector<int>                      m_Batches;
+    vector<std::pair<uint64_t, int>> m_Cells;
+    vector<std::pair<int, int>>      m_Overlaps;
 };
 
 struct NodeSettings
@@ -521,6 +1094,7 @@ struct Settings
         , m_DirtyReason(SaveReasonFlags::None)
         , m_ViewScroll(0, 0)
         , m_ViewZoom(1.0f)
+        , m_NodeMapData(nullptr)
     {
     }
 
@@ -533,6 +1107,13 @@ struct Settings
     std::string Serialize();
 
     static bool Parse(const std::string& string, Settings& settings);
+
+private:
+    void SyncNodeMap();
+
+    // Lookup into m_Nodes, rebuilt when vector storage moves (growth or copy).
+    ObjectMap<NodeSettings, NodeId> m_NodeMap;
+    const NodeSettings*             m_NodeMapData;
 };
 
 struct Control
@@ -742,6 +1323,8 @@ struct FlowAnimationController final : AnimationController
 
     void Release(FlowAnimation* animation);
 
+    void ForgetObjects(const vector<Object*>& deadObjects);
+
 private:
     FlowAnimation* GetOrCreate(Link* link);
 
@@ -772,6 +1355,9 @@ struct EditorAction
 
     virtual void ShowMetrics() {}
 
+    // Drop references to objects which are about to be freed. 'deadObjects' is sorted.
+    virtual void ForgetObjects(const vector<Object*>& deadObjects) { IM_UNUSED(deadObjects); }
+
     virtual NavigateAction*     AsNavigate()     { return nullptr; }
     virtual SizeAction*         AsSize()         { return nullptr; }
     virtual DragAction*         AsDrag()         { return nullptr; }
@@ -811,6 +1397,8 @@ struct NavigateAction final: EditorAction
 
     virtual void ShowMetrics() override final;
 
+    virtual void ForgetObjects(const vector<Object*>& deadObjects) override final;
+
     virtual NavigateAction* AsNavigate() override final { return this; }
 
     void NavigateTo(const ImRect& bounds, bool zoomIn, float duration = -1.0f, NavigationReason reason = NavigationReason::Unknown);
@@ -871,6 +1459,8 @@ struct SizeAction final: EditorAction
 
     virtual void ShowMetrics() override final;
 
+    virtual void ForgetObjects(const vector<Object*>& deadObjects) override final;
+
     virtual SizeAction* AsSize() override final { return this; }
 
     virtual bool IsDragging() override final { return m_IsActive; }
@@ -895,7 +1485,8 @@ struct DragAction final: EditorAction
     bool            m_IsActive;
     bool            m_Clear;
     Object*         m_DraggedObject;
-    vector<Object*> m_Objects;
+    vector<Node*>   m_Nodes;    // Dragged nodes, moved by MoveNodes() instead of Object::UpdateDrag()
+    vector<Object*> m_Objects;  // Other dragged objects
 
     DragAction(EditorContext* editor);
 
@@ -910,7 +1501,13 @@ struct DragAction final: EditorAction
 
     virtual void ShowMetrics() override final;
 
+    virtual void ForgetObjects(const vector<Object*>& deadObjects) override final;
+
     virtual DragAction* AsDrag() override final { return this; }
+
+private:
+    bool Pick(Object* object);
+    void MoveNodes(const ImVec2& offset);
 };
 
 struct SelectAction final: EditorAction
@@ -936,6 +1533,8 @@ struct SelectAction final: EditorAction
 
     virtual void ShowMetrics() override final;
 
+    virtual void ForgetObjects(const vector<Object*>& deadObjects) override final;
+
     virtual bool IsDragging() override final { return m_IsActive; }
 
     virtual SelectAction* AsSelect() override final { return this; }
@@ -988,6 +1587,8 @@ struct ShortcutAction final: EditorAction
 
     virtual void ShowMetrics() override final;
 
+    virtual void ForgetObjects(const vector<Object*>& deadObjects) override final;
+
     virtual ShortcutAction* AsCutCopyPaste() override final { return this; }
 
     bool Begin();
@@ -1058,6 +1659,8 @@ struct CreateItemAction final : EditorAction
 
     virtual void ShowMetrics() override final;
 
+    virtual void ForgetObjects(const vector<Object*>& deadObjects) override final;
+
     virtual bool IsDragging() override final { return m_IsActive; }
 
     virtual CreateItemAction* AsCreateItem() override final { return this; }
@@ -1075,6 +1678,7 @@ struct CreateItemAction final : EditorAction
 
 private:
     bool m_IsInGlobalSpace;
+    int  m_GlobalSpaceChannel;
 
     void DragStart(Pin* startPin);
     void DragEnd();
@@ -1097,6 +1701,8 @@ struct DeleteItemsAction final: EditorAction
 
     virtual void ShowMetrics() override final;
 
+    virtual void ForgetObjects(const vector<Object*>& deadObjects) override final;
+
     virtual DeleteItemsAction* AsDeleteItems() override final { return this; }
 
     bool Add(Object* object);
@@ -1106,23 +1712,33 @@ struct DeleteItemsAction final: EditorAction
 
     bool QueryLink(LinkId* linkId, PinId* startId = nullptr, PinId* endId = nullptr);
     bool QueryNode(NodeId* nodeId);
+    int  QueryLinks(LinkId* linkIds, int size);
+    int  QueryNodes(NodeId* nodeIds, int size);
 
+    // Accepts or rejects all items returned by last query.
     bool AcceptItem();
     void RejectItem();
 
 private:
-    enum IteratorType { Unknown, Link, Node };
+    enum IteratorType { Unknown, Link, Node, IteratorTypeCount };
     enum UserAction { Undetermined, Accepted, Rejected };
 
-    bool QueryItem(ObjectId* itemId, IteratorType itemType);
-    void RemoveItem();
+    static bool IsItemOfType(Object* item, IteratorType itemType);
+
+    int  QueryItems(IteratorType itemType, int size);
+    int  CountItems(IteratorType itemType) const;
+    template <typename F>
+    void ForEachQueriedItem(F&& callback);
+    void RemoveItems();
 
     vector<Object*> m_ManuallyDeletedObjects;
 
     IteratorType    m_CurrentItemType;
     UserAction      m_UserAction;
-    vector<Object*> m_CandidateObjects;
-    int             m_CandidateItemIndex;
+    vector<Object*> m_CandidateObjects;                    // Processed items are set to null until End()
+    vector<Object*> m_RemovedObjects;                      // Deselected in bulk by End()
+    int             m_CandidateItemIndex[IteratorTypeCount]; // First unprocessed item of each type
+    int             m_QueriedItemsEnd;
 };
 
 struct NodeBuilder
@@ -1143,6 +1759,12 @@ struct NodeBuilder
 
     ImRect m_GroupBounds;
     bool   m_IsGroup;
+    bool   m_IsCulled;
+    bool   m_IsReplayed;
+
+    uint64_t m_ContentVersion;
+    int      m_ContentVertexStart;
+    ImGuiID  m_ActiveIdIsAlive;    // ImGui active item was already submitted when node began
 
     ImDrawListSplitter m_Splitter;
     ImDrawListSplitter m_PinSplitter;
@@ -1150,7 +1772,7 @@ struct NodeBuilder
     NodeBuilder(EditorContext* editor);
     ~NodeBuilder();
 
-    void Begin(NodeId nodeId);
+    bool Begin(NodeId nodeId, uint64_t contentVersion = 0);
     void End();
 
     void BeginPin(PinId pinId, PinKind kind);
@@ -1167,6 +1789,9 @@ struct NodeBuilder
 
     ImDrawList* GetUserBackgroundDrawList() const;
     ImDrawList* GetUserBackgroundDrawList(Node* node) const;
+
+private:
+    bool IsContentHovered() const;
 };
 
 struct HintBuilder
@@ -1251,6 +1876,7 @@ struct EditorContext
     ~EditorContext();
 
     Style& GetStyle() { return m_Style; }
+    const Config& GetConfig() const { return m_Config; }
 
     void Begin(const char* id, const ImVec2& size = ImVec2(0, 0));
     void End();
@@ -1272,9 +1898,18 @@ struct EditorContext
     const ImRect& GetViewRect() const { return m_Canvas.ViewRect(); }
     const ImRect& GetRect() const { return m_Canvas.Rect(); }
 
+    LevelOfDetail GetLevelOfDetail() const;
+
     void SetNodePosition(NodeId nodeId, const ImVec2& screenPosition);
+    void SetNodePositions(const NodeId* nodeIds, const ImVec2* positions, int count);
     ImVec2 GetNodePosition(NodeId nodeId);
     ImVec2 GetNodeSize(NodeId nodeId);
+    bool IsNodeVisible(NodeId nodeId);
+    bool IsNodeVisible(Node* node);
+
+    // Bounds of everything drawn for the node: group, pins and borders.
+    float  GetNodeDrawMargin() const;
+    ImRect GetNodeDrawBounds(Node* node, float margin, const ImVec2& pinOffset = ImVec2(0, 0)) const;
 
     void MarkNodeToRestoreState(Node* node);
     void RestoreNodeState(Node* node);
@@ -1282,6 +1917,8 @@ struct EditorContext
     void ClearSelection();
     void SelectObject(Object* object);
     void DeselectObject(Object* object);
+    void DeselectObjects(const vector<Object*>& objects);
+    void SelectObjects(Object* const* objects, int count, bool append);
     void SetSelectedObject(Object* object);
     void ToggleObjectSelection(Object* object);
     bool IsSelected(Object* object);
@@ -1291,14 +1928,50 @@ struct EditorContext
     bool HasSelectionChanged();
     uint64_t GetSelectionId() const { return m_SelectionId; }
 
+    // Objects which selection was changed during the frame. Object was
+    // selected if m_IsSelected is set and m_WasSelected is not, deselected
+    // in opposite case. Objects may end up in the state they started in.
+    const vector<Object*>& GetSelectionChanges() const { return m_SelectionChanges; }
+
+    void UpdateNodeIndex(Node* node);
+    void UpdateLinkIndex(Link* link);
+
+    // Moves pin to node, links attached to the pin follow it.
+    void SetPinNode(Pin* pin, Node* node);
+
+    // Nodes are kept in draw order: groups sorted by area first, then regular nodes.
+    // Node::m_DrawOrder is an index into that order.
+    void UpdateNodeOrder(Node* node);
+    void BringNodeToFront(Node* node);
+    void BringNodesToFront(vector<Node*>& nodes);
+    float GetGroupOrderArea(Node* node) const;
+    void RenumberNodes(int first, int last);
+
+    // Group tree is updated lazily, nodes which changed bounds or type are
+    // marked dirty and resolved on next query.
+    void MarkGroupTreeDirty(Node* node);
+    void UpdateGroupTree();
+    Node* GetParentGroup(Node* node);
+    void GetGroupChildren(Node* group, vector<Node*>& result);
+
+    // Node queries go through spatial index. Nodes dragged by DragAction are
+    // indexed at their drag start position until the drag ends.
     Node* FindNodeAt(const ImVec2& p);
     void FindNodesInRect(const ImRect& r, vector<Node*>& result, bool append = false, bool includeIntersecting = true);
     void FindLinksInRect(const ImRect& r, vector<Link*>& result, bool append = false);
 
     void FindLinksForNode(NodeId nodeId, vector<Link*>& result, bool add = false);
+    void FindLinksForPin(PinId pinId, vector<Link*>& result, bool add = false);
 
     bool PinHadAnyLinks(PinId pinId);
 
+    int GetReclaimedObjectCount() const { return m_ReclaimedObjectCount; }
+
+    ScratchArena& GetScratch() { return m_Scratch; }
+
+    const FrameStats& GetFrameStats() const { return m_LastFrameStats; }
+    int GetFrameStatsHistory(FrameStats* stats, int size) const;
+
     ImVec2 ToCanvas(const ImVec2& point) const { return m_Canvas.ToLocal(point); }
     ImVec2 ToScreen(const ImVec2& point) const { return m_Canvas.FromLocal(point); }
 
@@ -1308,11 +1981,21 @@ struct EditorContext
     void Resume(SuspendFlags flags = SuspendFlags::None);
     bool IsSuspended();
 
+    // Content drawn into editor channel while suspended stays in screen space
+    // when renderer applies canvas transform. Call before Suspend() and after
+    // Resume(), does nothing if canvas is already suspended.
+    void BeginScreenSpaceChannel(int channel);
+    void EndScreenSpaceChannel(int channel);
+
     bool IsActive();
 
     void MakeDirty(SaveReasonFlags reason);
     void MakeDirty(SaveReasonFlags reason, Node* node);
 
+    void BeginFrameStats();
+    void RecordFrameStat(float FrameStats::* phase); // Time since last record goes to phase, nullptr to skip it
+    void EndFrameStats();
+
     Pin*    CreatePin(PinId id, PinKind kind);
     Node*   CreateNode(NodeId id);
     Link*   CreateLink(LinkId id);
@@ -1326,6 +2009,8 @@ struct EditorContext
     Pin*   GetPin(PinId id, PinKind kind);
     Link*  GetLink(LinkId id);
 
+    void SortLinks();
+
     Link* FindLinkAt(const ImVec2& p);
 
     template <typename T>
@@ -1334,7 +2019,7 @@ struct EditorContext
         ImRect bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
 
         for (auto object : objects)
-            if (object->m_IsLive)
+            if (object->IsLive())
                 bounds.Add(object->GetBounds());
 
         if (ImRect_IsEmpty(bounds))
@@ -1349,7 +2034,7 @@ struct EditorContext
         ImRect bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
 
         for (auto object : objects)
-            if (object.m_Object->m_IsLive)
+            if (object.m_Object->IsLive())
                 bounds.Add(object.m_Object->GetBounds());
 
         if (ImRect_IsEmpty(bounds))
@@ -1408,6 +2093,18 @@ private:
 
     void UpdateAnimations();
 
+    void MarkSelectionChanged(Object* object);
+
+    void AttachLink(Link* link);
+    void DetachLink(Link* link);
+    void AttachLinkToNodes(Link* link);
+    void DetachLinkFromNodes(Link* link);
+
+    void CollectDeadObjects();
+
+    Node* FindParentGroup(Node* node);
+    void SetParentGroup(Node* node, Node* parent);
+
     bool                m_IsFirstFrame;
     bool                m_IsWindowActive;
 
@@ -1419,14 +2116,53 @@ private:
     vector<ObjectWrapper<Node>> m_Nodes;
     vector<ObjectWrapper<Pin>>  m_Pins;
     vector<ObjectWrapper<Link>> m_Links;
+    int                 m_SortedLinkCount;
+
+    ObjectPool<Node>    m_NodePool;
+    ObjectPool<Pin>     m_PinPool;
+    ObjectPool<Link>    m_LinkPool;
+
+    ObjectStates        m_NodeStates;
+    ObjectStates        m_PinStates;
+    ObjectStates        m_LinkStates;
+
+    ObjectMap<Node>     m_NodeMap;
+    ObjectMap<Pin>      m_PinMap;
+    ObjectMap<Link>     m_LinkMap;
+
+    SpatialGrid         m_NodeIndex;
+    SpatialGrid         m_LinkIndex;
+    vector<Object*>     m_IndexQuery;
+    vector<Node*>       m_GroupTreeDirtyNodes;
+
+    ScratchArena        m_Scratch;
+
+    NodeBatcher         m_NodeBatcher;
+    vector<Node*>       m_BatchedNodes;
+    vector<ImRect>      m_BatchedBounds;
+    vector<int>         m_BatchedChannels;      // Target channel of every node channel slot in a batch, -1 if slot is empty
 
     vector<Object*>     m_SelectedObjects;
 
-    vector<Object*>     m_LastSelectedObjects;
-    uint64_t            m_SelectionId;
+    vector<Object*>     m_SelectionChanges;
+    uint64_t            m_SelectionId;          // Bumped on every selection change
+    uint64_t            m_LastSelectionId;      // Selection id at the beginning of the frame
 
     Link*               m_LastActiveLink;
 
+    int                 m_FrameIndex;
+    int                 m_ReclaimedObjectCount;
+
+    using Clock = std::chrono::steady_clock;
+
+    FrameStats          m_FrameStats;
+    FrameStats          m_LastFrameStats;
+    Clock::time_point   m_FrameStatsStart;
+    Clock::time_point   m_FrameStatsLap;
+    vector<FrameStats>  m_FrameStatsHistory;    // Ring buffer
+    int                 m_FrameStatsHistoryNext;
+    int                 m_FrameStatsScratchGrowthCount;
+
     vector<Animation*>  m_LiveAnimations;
     vector<Animation*>  m_LastLiveAnimations;
 
@@ -0,0 +1,456 @@
+# include "test.h"
+# include <imgui_node_editor_internal.h>
+# include <chrono>
+# include <string.h>
+# include <math.h>
+
+// Benchmarks print their measurements to stdout. They are registered like
+// tests, checks guard correctness of the measured code path.
+
+using Clock = std::chrono::high_resolution_clock;
+
+static float ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+// Time of the first editor frame, which creates every node, pin and link,
+// compared to a steady frame submitting the same graph again. Growth of the
+// first frame time between consecutive N is printed next to growth expected
+// from N log N and N^2 log N, so complexity of object creation is visible
+// regardless of machine speed.
+TEST(Benchmark_FirstFrame)
+{
+    const int c_NodeCounts[]  = { 1000, 2000, 4000, 8000, 16000 };
+    const int c_Repeats       = 3;
+    const int c_SteadyFrames  = 10;
+
+    printf("First frame (chain of N nodes, N - 1 links, best of %d):\n", c_Repeats);
+
+    auto nLogN = [](float n) { return n * log2f(n); };
+
+    float previousFirstFrame = 0.0f;
+    int   previousNodeCount  = 0;
+    for (auto nodeCount : c_NodeCounts)
+    {
+        ChainGraph graph(nodeCount);
+
+        float firstFrame  = FLT_MAX;
+        float steadyFrame = FLT_MAX;
+        for (int repeat = 0; repeat < c_Repeats; ++repeat)
+        {
+            auto config = EditorFixture::DefaultConfig();
+            config.EnableFrameStats = true;
+
+            EditorFixture fixture(config);
+
+            float steady = 0.0f;
+            for (int frame = 0; frame <= c_SteadyFrames; ++frame)
+            {
+                fixture.BeginFrame();
+                graph.Submit(frame == 0);
+                fixture.EndFrame();
+
+                // Begin() to End(), ImGui frame is not included.
+                auto time = ed::GetFrameStats().Total;
+
+                if (frame == 0)
+                    firstFrame = ImMin(firstFrame, time);
+                else
+                    steady += time / c_SteadyFrames;
+            }
+
+            steadyFrame = ImMin(steadyFrame, steady);
+        }
+
+        printf("  N=%-6d first: %8.2f ms  steady: %8.2f ms", nodeCount, firstFrame, steadyFrame);
+        if (previousNodeCount > 0)
+        {
+            const float n0 = static_cast<float>(previousNodeCount);
+            const float n1 = static_cast<float>(nodeCount);
+            printf("  growth: x%.2f (N log N: x%.2f, N^2 log N: x%.2f)",
+                firstFrame / previousFirstFrame, nLogN(n1) / nLogN(n0), n1 * nLogN(n1) / (n0 * nLogN(n0)));
+        }
+        printf("\n");
+
+        previousFirstFrame = firstFrame;
+        previousNodeCount  = nodeCount;
+    }
+}
+
+// Per-object state as it was kept before ObjectStates tables: flags inside
+// heap allocated objects, reset by a virtual call and culled against bounds
+// computed on demand. Padding keeps objects as large as the real ones, so
+// both layouts touch memory the same way the editor does.
+struct LegacyObject
+{
+    bool m_IsLive = true;
+
+    virtual ~LegacyObject() = default;
+
+    virtual void   Reset() { m_IsLive = false; }
+    virtual ImRect GetBounds() const = 0;
+
+    bool IsVisible(const ImRect& clipRect) const
+    {
+        if (!m_IsLive)
+            return false;
+
+        return clipRect.Overlaps(GetBounds());
+    }
+};
+
+struct LegacyNode final : LegacyObject
+{
+    ImRect        m_Bounds;
+    unsigned char m_Rest[sizeof(ed::Detail::Node)];
+
+    ImRect GetBounds() const override { return m_Bounds; }
+};
+
+struct LegacyPin final : LegacyObject
+{
+    ImRect        m_Bounds;
+    bool          m_HasConnection = false;
+    bool          m_HadConnection = false;
+    unsigned char m_Rest[sizeof(ed::Detail::Pin)];
+
+    void Reset() override
+    {
+        m_HadConnection = m_HasConnection && m_IsLive;
+        m_HasConnection = false;
+
+        LegacyObject::Reset();
+    }
+
+    ImRect GetBounds() const override { return m_Bounds; }
+};
+
+struct LegacyLink final : LegacyObject
+{
+    ImCubicBezierPoints m_Curve;
+    float               m_Thickness = 1.0f;
+    unsigned char       m_Rest[sizeof(ed::Detail::Link)];
+
+    ImRect GetBounds() const override
+    {
+        auto bounds = ImCubicBezierBoundingRect(m_Curve);
+        bounds.Expand(m_Thickness * 0.5f);
+        return bounds;
+    }
+};
+
+// Reset and cull passes alone, old per-object layout next to the tables.
+// Graph is laid out like ChainGraph, so only a small part is in view.
+static void MeasureObjectStatePasses(const ChainGraph& graph, int repeats)
+{
+    using ed::Detail::ObjectStates;
+
+    const ImRect clipRect(ImVec2(0.0f, 0.0f), ImVec2(1280.0f, 720.0f));
+    const int    nodeCount = graph.NodeCount();
+    const int    linkCount = graph.LinkCount();
+    const ImVec2 nodeSize(120.0f, 40.0f);
+
+    auto nodeBounds = [&](int i) { return ImRect(graph.PositionAt(i), graph.PositionAt(i) + nodeSize); };
+    auto pinBounds  = [&](int i, int side)
+    {
+        auto bounds = nodeBounds(i);
+        return ImRect(ImVec2(side ? bounds.Max.x - 16.0f : bounds.Min.x, bounds.Min.y + 12.0f), ImVec2(side ? bounds.Max.x : bounds.Min.x + 16.0f, bounds.Min.y + 28.0f));
+    };
+    auto linkCurve  = [&](int i)
+    {
+        const auto start = pinBounds(i, 1).GetCenter();
+        const auto end   = pinBounds(i + 1, 0).GetCenter();
+        return ImCubicBezierPoints{ start, start + ImVec2(50.0f, 0.0f), end - ImVec2(50.0f, 0.0f), end };
+    };
+
+    // Array of structures, objects allocated one by one in submission order.
+    std::vector<LegacyObject*> legacyNodes, legacyPins, legacyLinks;
+    for (int i = 0; i < nodeCount; ++i)
+    {
+        auto node = new LegacyNode();
+        node->m_Bounds = nodeBounds(i);
+        legacyNodes.push_back(node);
+
+        for (int side = 0; side < 2; ++side)
+        {
+            auto pin = new LegacyPin();
+            pin->m_Bounds        = pinBounds(i, side);
+            pin->m_HasConnection = (side == 1 && i < linkCount) || (side == 0 && i > 0);
+            legacyPins.push_back(pin);
+        }
+    }
+    for (int i = 0; i < linkCount; ++i)
+    {
+        auto link = new LegacyLink();
+        link->m_Curve = linkCurve(i);
+        legacyLinks.push_back(link);
+    }
+
+    // Tables, bounds are stored when objects are submitted.
+    ObjectStates nodeStates, pinStates, linkStates;
+    for (int i = 0; i < nodeCount; ++i)
+    {
+        nodeStates.SetBounds(nodeStates.Allocate(), nodeBounds(i));
+        for (int side = 0; side < 2; ++side)
+        {
+            const auto index = pinStates.Allocate();
+            pinStates.SetBounds(index, pinBounds(i, side));
+            pinStates.Set(index, ObjectStates::HasConnection, (side == 1 && i < linkCount) || (side == 0 && i > 0));
+        }
+    }
+    for (int i = 0; i < linkCount; ++i)
+    {
+        const auto index = linkStates.Allocate();
+        const auto curve = linkCurve(i);
+        auto bounds = ImCubicBezierBoundingRect(curve);
+        bounds.Expand(0.5f);
+        linkStates.SetBounds(index, bounds);
+    }
+
+    float legacyReset = FLT_MAX, legacyCull = FLT_MAX;
+    float tableReset  = FLT_MAX, tableCull  = FLT_MAX;
+    int   legacyVisible = 0, tableVisible = 0;
+    for (int repeat = 0; repeat < repeats; ++repeat)
+    {
+        auto start = Clock::now();
+        for (auto node : legacyNodes) node->Reset();
+        for (auto pin  : legacyPins)  pin->Reset();
+        for (auto link : legacyLinks) link->Reset();
+        legacyReset = ImMin(legacyReset, ElapsedMs(start));
+
+        // Everything is submitted again, not measured.
+        for (auto node : legacyNodes) node->m_IsLive = true;
+        for (auto pin  : legacyPins)  pin->m_IsLive  = true;
+        for (auto link : legacyLinks) link->m_IsLive = true;
+
+        // Editor draws only visible nodes and links.
+        legacyVisible = 0;
+        start = Clock::now();
+        for (auto node : legacyNodes) legacyVisible += node->IsVisible(clipRect) ? 1 : 0;
+        for (auto link : legacyLinks) legacyVisible += link->IsVisible(clipRect) ? 1 : 0;
+        legacyCull = ImMin(legacyCull, ElapsedMs(start));
+
+        start = Clock::now();
+        nodeStates.Reset();
+        pinStates.Reset();
+        linkStates.Reset();
+        tableReset = ImMin(tableReset, ElapsedMs(start));
+
+        for (int i = 0; i < nodeCount; ++i)     nodeStates.Set(i, ObjectStates::Live, true);
+        for (int i = 0; i < nodeCount * 2; ++i) pinStates.Set(i, ObjectStates::Live, true);
+        for (int i = 0; i < linkCount; ++i)     linkStates.Set(i, ObjectStates::Live, true);
+
+        start = Clock::now();
+        nodeStates.Cull(clipRect);
+        linkStates.Cull(clipRect);
+        tableCull = ImMin(tableCull, ElapsedMs(start));
+
+        tableVisible = 0;
+        for (int i = 0; i < nodeCount; ++i) tableVisible += nodeStates.Has(i, ObjectStates::Visible) ? 1 : 0;
+        for (int i = 0; i < linkCount; ++i) tableVisible += linkStates.Has(i, ObjectStates::Visible) ? 1 : 0;
+    }
+
+    printf("  N=%-6d objects (AoS):    reset: %7.3f ms  cull: %7.3f ms\n", nodeCount, legacyReset, legacyCull);
+    printf("  N=%-6d objects (tables): reset: %7.3f ms  cull: %7.3f ms  speedup: x%.1f\n", nodeCount, tableReset, tableCull,
+        (legacyReset + legacyCull) / ImMax(tableReset + tableCull, 0.001f));
+
+    // Both layouts must agree on what is drawn.
+    CHECK(legacyVisible > 0);
+    CHECK_EQUAL(tableVisible, legacyVisible);
+
+    for (auto object : legacyNodes) delete object;
+    for (auto object : legacyPins)  delete object;
+    for (auto object : legacyLinks) delete object;
+}
+
+// Per-frame passes over object state: resetting it in Begin() and culling
+// in End(). Only a small part of the graph is on screen, so drawing does
+// not hide the cost of culling objects that are off screen.
+TEST(Benchmark_ObjectState)
+{
+    const int c_NodeCounts[]  = { 10000, 100000 };
+    const int c_SteadyFrames  = 20;
+
+    printf("Object state passes (chain of N nodes, 2 pins each, best of %d):\n", c_SteadyFrames);
+
+    for (auto nodeCount : c_NodeCounts)
+        MeasureObjectStatePasses(ChainGraph(nodeCount), c_SteadyFrames);
+
+    printf("Object state in editor (steady frames):\n");
+
+    for (auto nodeCount : c_NodeCounts)
+    {
+        ChainGraph graph(nodeCount);
+
+        auto config = EditorFixture::DefaultConfig();
+        config.LightweightNodes = true;
+        config.EnableFrameStats = true;
+        config.NodeCapacityHint = nodeCount;
+        config.PinCapacityHint  = nodeCount * 2;
+        config.LinkCapacityHint = graph.LinkCount();
+
+        EditorFixture fixture(config);
+
+        float reset = 0.0f;
+        float draw  = 0.0f;
+        float total = 0.0f;
+        for (int frame = 0; frame <= c_SteadyFrames; ++frame)
+        {
+            fixture.BeginFrame();
+            graph.Submit(frame == 0);
+            fixture.EndFrame();
+
+            if (frame == 0)
+                continue;
+
+            auto stats = ed::GetFrameStats();
+            reset += stats.Reset / c_SteadyFrames;
+            draw  += stats.Draw  / c_SteadyFrames;
+            total += stats.Total / c_SteadyFrames;
+        }
+
+        printf("  N=%-6d objects: %-7d reset: %7.3f ms  cull + draw: %7.3f ms  frame: %8.2f ms\n",
+            nodeCount, nodeCount * 3 + graph.LinkCount(), reset, draw, total);
+    }
+}
+
+// Canvas position transform with multiply and add rounded separately. The
+// product of two floats is exact in double, rounding it to float and adding
+// in double cannot be fused into FMA, whatever the compiler flags.
+static ImVec2 ReferenceTransform(const ImVec2& position, const ImVec2& offset, float scale)
+{
+    auto x = static_cast<float>(static_cast<double>(position.x) * scale);
+    auto y = static_cast<float>(static_cast<double>(position.y) * scale);
+    return ImVec2(
+        static_cast<float>(static_cast<double>(x) + offset.x),
+        static_cast<float>(static_cast<double>(y) + offset.y));
+}
+
+// Throughput of moving canvas vertices to the screen in Canvas::End(),
+// which uses SIMD kernels unless IMGUI_EX_CANVAS_NO_SIMD is defined.
+// Every transformed vertex is compared bit for bit with the reference.
+TEST(Benchmark_CanvasTransform)
+{
+    const int   c_VertexCounts[] = { 100000, 1000000, 10000000 };
+    const float c_Scales[]       = { 0.37f, 1.0f };
+    const int   c_Repeats        = 5;
+
+    printf("Canvas transform (best of %d, Mvtx/s):\n", c_Repeats);
+
+    HeadlessContext context;
+    ImGuiEx::Canvas canvas;
+    ImVector<ImVec2> positions;
+
+    for (auto vertexCount : c_VertexCounts)
+    {
+        printf("  %-8d", vertexCount);
+
+        for (auto scale : c_Scales)
+        {
+            float bestTime   = FLT_MAX;
+            int   mismatches = 0;
+            for (int repeat = 0; repeat < c_Repeats; ++repeat)
+            {
+                context.BeginFrame();
+
+                canvas.SetView(ImVec2(13.25f, -7.5f), scale);
+                if (!canvas.Begin("##canvas", ImVec2(0.0f, 0.0f)))
+                {
+                    context.EndFrame();
+                    continue;
+                }
+
+                auto drawList = ImGui::GetWindowDrawList();
+                auto vertexStart = drawList->VtxBuffer.Size;
+                for (int i = 0; i < vertexCount / 4; ++i)
+                {
+                    auto p = ImVec2(static_cast<float>(i % 500) * 4.0f + 0.1f, static_cast<float>(i / 500) * 4.0f + 0.3f);
+                    drawList->AddRectFilled(p, p + ImVec2(3.0f, 3.0f), IM_COL32(255, 128, 0, 255));
+                }
+
+                positions.resize(drawList->VtxBuffer.Size - vertexStart);
+                for (int i = 0; i < positions.Size; ++i)
+                    positions[i] = drawList->VtxBuffer[vertexStart + i].pos;
+
+                // Point zero in canvas is the translation part of the transform.
+                auto offset = canvas.FromLocal(ImVec2(0.0f, 0.0f));
+
+                auto start = Clock::now();
+                canvas.End();
+                bestTime = ImMin(bestTime, ElapsedMs(start));
+
+                for (int i = 0; i < positions.Size; ++i)
+                {
+                    auto expected = ReferenceTransform(positions[i], offset, scale);
+                    auto actual   = drawList->VtxBuffer[vertexStart + i].pos;
+                    if (memcmp(&expected, &actual, sizeof(ImVec2)) != 0)
+                        ++mismatches;
+                }
+
+                context.EndFrame();
+            }
+
+            printf("  scale %.2f: %7.1f%s", scale,
+                bestTime > 0.0f ? vertexCount / (bestTime * 1000.0f) : 0.0f,
+                mismatches ? " (MISMATCH)" : "");
+
+            CHECK_EQUAL(mismatches, 0);
+        }
+
+        printf("\n");
+    }
+}
+
+// Every node placed at the same position, so each pair of nodes overlaps.
+// Batching nodes into shared draw channels must give up early instead of
+// collecting all N^2 / 2 overlapping pairs. Empty channels of nodes are
+// dropped regardless of batching.
+TEST(Benchmark_CoincidentNodes)
+{
+    const int c_NodeCounts[]  = { 1000, 10000 };
+    const int c_SteadyFrames  = 5;
+
+    printf("Coincident nodes (steady frames):\n");
+
+    for (auto nodeCount : c_NodeCounts)
+    {
+        ChainGraph graph(nodeCount, 1);
+
+        auto config = EditorFixture::DefaultConfig();
+        config.EnableFrameStats = true;
+
+        EditorFixture fixture(config);
+
+        float channelReorder = 0.0f;
+        float total          = 0.0f;
+        ed::FrameStats stats;
+        for (int frame = 0; frame <= c_SteadyFrames; ++frame)
+        {
+            fixture.BeginFrame();
+            for (int i = 0; i < nodeCount; ++i)
+            {
+                if (frame == 0)
+                    ed::SetNodePosition(graph.NodeAt(i), ImVec2(0.0f, 0.0f));
+
+                ed::BeginNode(graph.NodeAt(i));
+                ImGui::TextUnformatted("Node");
+                ed::EndNode();
+            }
+            fixture.EndFrame();
+
+            if (frame == 0)
+                continue;
+
+            stats = ed::GetFrameStats();
+            channelReorder += stats.ChannelReorder / c_SteadyFrames;
+            total          += stats.Total          / c_SteadyFrames;
+        }
+
+        printf("  N=%-6d channel reorder: %7.3f ms  frame: %8.2f ms  channels: %d -> %d\n",
+            nodeCount, channelReorder, total, stats.ChannelCount, stats.CompactChannelCount);
+
+        // Nodes have no pins and no user background.
+        CHECK(stats.CompactChannelCount < stats.ChannelCount);
+    }
+}
@@ -0,0 +1,143 @@
+# include "fixture.h"
+
+HeadlessContext::HeadlessContext(const ImVec2& displaySize)
+    : m_PreviousContext(ImGui::GetCurrentContext())
+    , m_PreviousEditor(ed::GetCurrentEditor())
+    , m_Context(ImGui::CreateContext(&m_Fonts))
+{
+    ImGui::SetCurrentContext(m_Context);
+
+    unsigned char* pixels = nullptr;
+    int width = 0, height = 0;
+    m_Fonts.AddFontDefault();
+    m_Fonts.GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    auto& io = ImGui::GetIO();
+    io.IniFilename  = nullptr;
+    io.DisplaySize  = displaySize;
+    io.DeltaTime    = 1.0f / 60.0f;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    ImGui::DestroyContext(m_Context);
+    ImGui::SetCurrentContext(m_PreviousContext);
+    ed::SetCurrentEditor(m_PreviousEditor);
+}
+
+void HeadlessContext::BeginFrame()
+{
+    auto& io = ImGui::GetIO();
+
+    ImGui::NewFrame();
+    ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+    ImGui::SetNextWindowSize(io.DisplaySize);
+    ImGui::Begin("Headless", nullptr,
+        ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove |
+        ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse |
+        ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoBringToFrontOnFocus);
+}
+
+void HeadlessContext::EndFrame()
+{
+    ImGui::End();
+    ImGui::Render();
+}
+
+ed::Config EditorFixture::DefaultConfig()
+{
+    ed::Config config;
+    config.SettingsFile = nullptr;
+    return config;
+}
+
+EditorFixture::EditorFixture(const ed::Config& config, const ImVec2& displaySize)
+    : m_Context(displaySize)
+    , m_Config(config)
+    , m_Editor(ed::CreateEditor(&m_Config))
+{
+    ed::SetCurrentEditor(m_Editor);
+}
+
+EditorFixture::~EditorFixture()
+{
+    ed::DestroyEditor(m_Editor);
+}
+
+void EditorFixture::BeginFrame()
+{
+    m_Context.BeginFrame();
+    ed::SetCurrentEditor(m_Editor);
+
+    const auto canvasScreenMin = ImGui::GetCursorScreenPos();
+    ed::Begin("Editor");
+    m_ViewMin = ed::ScreenToCanvas(canvasScreenMin);
+}
+
+void EditorFixture::EndFrame()
+{
+    ed::End();
+    m_Context.EndFrame();
+}
+
+void ChainGraph::Submit(bool place)
+{
+    for (int i = 0; i < m_NodeCount; ++i)
+    {
+        if (place)
+            ed::SetNodePosition(NodeAt(i), PositionAt(i));
+
+        if (ed::BeginNode(NodeAt(i)))
+        {
+            ed::BeginPin(InputAt(i), ed::PinKind::Input);
+                ImGui::TextUnformatted("->");
+            ed::EndPin();
+            ImGui::SameLine();
+            ed::BeginPin(OutputAt(i), ed::PinKind::Output);
+                ImGui::TextUnformatted("->");
+            ed::EndPin();
+        }
+        ed::EndNode();
+    }
+
+    for (int i = 0; i < LinkCount(); ++i)
+        ed::Link(LinkAt(i), OutputAt(i), InputAt(i + 1));
+}
+
+void EmulatedTransformCallback(const ImDrawList*, const ImDrawCmd*)
+{
+}
+
+void RenderDrawData(const ImDrawData* drawData, ImVector<RenderedVertex>& output)
+{
+    output.resize(0);
+
+    for (int i = 0; i < drawData->CmdListsCount; ++i)
+    {
+        auto drawList = drawData->CmdLists[i];
+
+        ImGuiEx::CanvasTransform transform;
+        for (auto& command : drawList->CmdBuffer)
+        {
+            if (command.UserCallback)
+            {
+                if (command.UserCallback == EmulatedTransformCallback)
+                    transform = *reinterpret_cast<const ImGuiEx::CanvasTransform*>(command.UserCallbackData);
+                continue;
+            }
+
+            for (unsigned int j = 0; j < command.ElemCount; ++j)
+            {
+                auto& vertex = drawList->VtxBuffer[command.VtxOffset + drawList->IdxBuffer[command.IdxOffset + j]];
+
+                RenderedVertex rendered;
+                rendered.Position = vertex.pos * transform.Scale + transform.Offset;
+                rendered.UV       = vertex.uv;
+                rendered.Color    = vertex.col;
+                rendered.ClipRect = command.ClipRect;
+                output.push_back(rendered);
+            }
+        }
+    }
+}
@@ -0,0 +1,118 @@
+# pragma once
+# ifndef IMGUI_DEFINE_MATH_OPERATORS
+#   define IMGUI_DEFINE_MATH_OPERATORS
+# endif
+# include <imgui.h>
+# include <imgui_internal.h>
+# include <imgui_node_editor.h>
+# include <imgui_canvas.h>
+
+namespace ed = ax::NodeEditor;
+
+// Private ImGui context with its own font atlas and no renderer. Previous
+// ImGui context and editor are restored on destruction, so tests and
+// benchmarks can be started from within a frame of an application.
+struct HeadlessContext
+{
+    explicit HeadlessContext(const ImVec2& displaySize = ImVec2(1280.0f, 720.0f));
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    // Starts a frame with a single window covering whole display.
+    void BeginFrame();
+    void EndFrame();
+
+private:
+    ImGuiContext*      m_PreviousContext;
+    ed::EditorContext* m_PreviousEditor;
+    ImFontAtlas        m_Fonts;
+    ImGuiContext*      m_Context;
+};
+
+// Editor living in its own headless context. Settings are not saved unless
+// config asks for it.
+struct EditorFixture
+{
+    static ed::Config DefaultConfig();
+
+    explicit EditorFixture(const ed::Config& config = DefaultConfig(), const ImVec2& displaySize = ImVec2(1280.0f, 720.0f));
+    ~EditorFixture();
+
+    EditorFixture(const EditorFixture&) = delete;
+    EditorFixture& operator=(const EditorFixture&) = delete;
+
+    // ImGui frame with editor begun in it.
+    void BeginFrame();
+    void EndFrame();
+
+    // Runs 'count' frames, 'submit' is called with frame index between
+    // ed::Begin() and ed::End().
+    template <typename F>
+    void RunFrames(int count, F&& submit)
+    {
+        for (int frame = 0; frame < count; ++frame)
+        {
+            BeginFrame();
+            submit(frame);
+            EndFrame();
+        }
+    }
+
+    // Top left corner of the editor in canvas space, updated by BeginFrame().
+    ImVec2 ViewMin() const { return m_ViewMin; }
+
+private:
+    HeadlessContext    m_Context;
+    ed::Config         m_Config;
+    ed::EditorContext* m_Editor;
+    ImVec2             m_ViewMin;
+};
+
+// Chain of nodes, each with one input and one output pin. Output of every
+// node is linked to input of the next one.
+struct ChainGraph
+{
+    ChainGraph(int nodeCount, int columns = 100)
+        : m_NodeCount(nodeCount)
+        , m_Columns(columns)
+    {
+    }
+
+    int NodeCount() const { return m_NodeCount; }
+    int LinkCount() const { return m_NodeCount > 0 ? m_NodeCount - 1 : 0; }
+
+    ed::NodeId NodeAt(int index) const { return static_cast<uintptr_t>(index * 3 + 1); }
+    ed::PinId  InputAt(int index) const { return static_cast<uintptr_t>(index * 3 + 2); }
+    ed::PinId  OutputAt(int index) const { return static_cast<uintptr_t>(index * 3 + 3); }
+    ed::LinkId LinkAt(int index) const { return static_cast<uintptr_t>(m_NodeCount * 3 + index + 1); }
+
+    ImVec2 PositionAt(int index) const
+    {
+        return ImVec2(static_cast<float>(index % m_Columns) * 160.0f, static_cast<float>(index / m_Columns) * 80.0f);
+    }
+
+    // Submits nodes and links, on first frame nodes are also placed.
+    // Content of nodes for which BeginNode() returns false is skipped.
+    void Submit(bool place);
+
+private:
+    int m_NodeCount;
+    int m_Columns;
+};
+
+// Transform callback recognized by RenderDrawData(), it is never called.
+void EmulatedTransformCallback(const ImDrawList*, const ImDrawCmd*);
+
+struct RenderedVertex
+{
+    ImVec2 Position;
+    ImVec2 UV;
+    ImU32  Color;
+    ImVec4 ClipRect;
+};
+
+// Flattens draw data to vertices of triangles the way a renderer would
+// see them, applying canvas transform from EmulatedTransformCallback.
+void RenderDrawData(const ImDrawData* drawData, ImVector<RenderedVertex>& output);
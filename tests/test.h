@@ -0,0 +1,53 @@
+# pragma once
+# include "fixture.h"
+# include <algorithm>
+# include <vector>
+
+// Minimal test runner. TEST() registers a test, CHECK() and CHECK_EQUAL()
+// record a failure and let the test continue. Checks are evaluated in every
+// build configuration, unlike IM_ASSERT.
+struct TestCase
+{
+    TestCase(const char* name, void (*function)());
+
+    const char* m_Name;
+    void      (*m_Function)();
+    TestCase*   m_Next;
+};
+
+void ReportCheckFailure(const char* file, int line, const char* expression);
+void ReportCheckFailure(const char* file, int line, const char* expression, long long actual, long long expected);
+
+# define TEST(name)                                     \
+    static void name();                                 \
+    static TestCase name##_TestCase(#name, name);       \
+    static void name()
+
+# define CHECK(expression)                                                      \
+    ((expression) ? (void)0 : ReportCheckFailure(__FILE__, __LINE__, #expression))
+
+# define CHECK_EQUAL(actual, expected)                                          \
+    do                                                                          \
+    {                                                                           \
+        const auto _actual   = static_cast<long long>(actual);                  \
+        const auto _expected = static_cast<long long>(expected);                \
+        if (_actual != _expected)                                               \
+            ReportCheckFailure(__FILE__, __LINE__, #actual " == " #expected,    \
+                _actual, _expected);                                            \
+    } while (false)
+
+using IdList = std::vector<uintptr_t>;
+
+// Ids returned by one of Get*() functions filling an id array, sorted.
+template <typename Id>
+inline IdList QueryIds(int (*query)(Id*, int))
+{
+    Id ids[16];
+    const int count = query(ids, IM_ARRAYSIZE(ids));
+
+    IdList result;
+    for (int i = 0; i < count; ++i)
+        result.push_back(ids[i].Get());
+    std::sort(result.begin(), result.end());
+    return result;
+}
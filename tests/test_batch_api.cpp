@@ -0,0 +1,140 @@
+# include "test.h"
+
+static const ed::NodeId c_UnknownNodeId = 1000;
+static const ed::LinkId c_UnknownLinkId = 1001;
+
+// Positions are applied to every node, including ones not submitted yet.
+TEST(BatchApi_SetNodePositions)
+{
+    EditorFixture fixture;
+    ChainGraph    graph(3);
+
+    const ed::NodeId nodeIds[]   = { graph.NodeAt(0), graph.NodeAt(1), graph.NodeAt(2) };
+    const ImVec2     positions[] = { ImVec2(10.0f, 20.0f), ImVec2(300.0f, -40.0f), ImVec2(-500.0f, 600.0f) };
+    const ImVec2     moved[]     = { ImVec2(70.0f, 80.0f), ImVec2(-90.0f, 100.0f) };
+
+    fixture.RunFrames(3, [&](int frame)
+    {
+        if (frame == 0)
+            ed::SetNodePositions(nodeIds, positions, IM_ARRAYSIZE(nodeIds));
+
+        graph.Submit(false);
+
+        // Only first two nodes are moved.
+        if (frame == 1)
+            ed::SetNodePositions(nodeIds, moved, IM_ARRAYSIZE(moved));
+    });
+
+    for (int i = 0; i < IM_ARRAYSIZE(nodeIds); ++i)
+    {
+        const auto expected = i < IM_ARRAYSIZE(moved) ? moved[i] : positions[i];
+        const auto position = ed::GetNodePosition(nodeIds[i]);
+        CHECK(position.x == expected.x && position.y == expected.y);
+    }
+}
+
+// Unknown ids are skipped. Replacing selection with the same set of nodes,
+// in any order, is not a change.
+TEST(BatchApi_SelectNodesAndLinks)
+{
+    EditorFixture fixture;
+    ChainGraph    graph(3);
+
+    const uintptr_t n0 = graph.NodeAt(0).Get(), n1 = graph.NodeAt(1).Get();
+    const uintptr_t l0 = graph.LinkAt(0).Get(), l1 = graph.LinkAt(1).Get();
+
+    fixture.RunFrames(5, [&](int frame)
+    {
+        graph.Submit(frame == 0);
+
+        switch (frame)
+        {
+            case 1:
+                {
+                    const ed::NodeId nodeIds[] = { n0, c_UnknownNodeId, n1 };
+                    ed::SelectNodes(nodeIds, IM_ARRAYSIZE(nodeIds));
+                }
+                CHECK(ed::HasSelectionChanged());
+                CHECK(QueryIds(ed::GetSelectedNodes) == IdList({ n0, n1 }));
+                CHECK(QueryIds(ed::GetSelectedLinks) == IdList());
+                break;
+
+            case 2:
+                {
+                    const ed::NodeId nodeIds[] = { n1, n0 };
+                    ed::SelectNodes(nodeIds, IM_ARRAYSIZE(nodeIds));
+                }
+                CHECK(!ed::HasSelectionChanged());
+                CHECK(QueryIds(ed::GetSelectedNodes) == IdList({ n0, n1 }));
+                CHECK(QueryIds(ed::GetSelectionAddedNodes) == IdList());
+                CHECK(QueryIds(ed::GetSelectionRemovedNodes) == IdList());
+                break;
+
+            case 3:
+                {
+                    const ed::LinkId linkIds[] = { c_UnknownLinkId, l0 };
+                    ed::SelectLinks(linkIds, IM_ARRAYSIZE(linkIds), true);
+                }
+                CHECK(ed::HasSelectionChanged());
+                CHECK(QueryIds(ed::GetSelectedNodes) == IdList({ n0, n1 }));
+                CHECK(QueryIds(ed::GetSelectedLinks) == IdList({ l0 }));
+                break;
+
+            case 4:
+                {
+                    const ed::LinkId linkIds[] = { l1, c_UnknownLinkId };
+                    ed::SelectLinks(linkIds, IM_ARRAYSIZE(linkIds));
+                }
+                CHECK(ed::HasSelectionChanged());
+                CHECK(QueryIds(ed::GetSelectedNodes) == IdList());
+                CHECK(QueryIds(ed::GetSelectedLinks) == IdList({ l1 }));
+                break;
+        }
+    });
+
+    CHECK_EQUAL(ed::GetSelectedObjectCount(), 1);
+}
+
+// Unknown ids are skipped and not counted as queued for deletion.
+TEST(BatchApi_DeleteNodesAndLinks)
+{
+    EditorFixture fixture;
+    ChainGraph    graph(4);
+
+    const uintptr_t n0 = graph.NodeAt(0).Get(), n3 = graph.NodeAt(3).Get();
+    const uintptr_t l0 = graph.LinkAt(0).Get(), l1 = graph.LinkAt(1).Get(), l2 = graph.LinkAt(2).Get();
+
+    int    deleteFrames = 0;
+    IdList deletedNodes, deletedLinks;
+    fixture.RunFrames(3, [&](int frame)
+    {
+        graph.Submit(frame == 0);
+
+        if (frame == 1)
+        {
+            const ed::NodeId nodeIds[] = { n0, c_UnknownNodeId, n3 };
+            const ed::LinkId linkIds[] = { c_UnknownLinkId, l1 };
+            CHECK_EQUAL(ed::DeleteNodes(nodeIds, IM_ARRAYSIZE(nodeIds)), 2);
+            CHECK_EQUAL(ed::DeleteLinks(linkIds, IM_ARRAYSIZE(linkIds)), 1);
+
+            const ed::NodeId unknownNodeIds[] = { c_UnknownNodeId };
+            CHECK_EQUAL(ed::DeleteNodes(unknownNodeIds, IM_ARRAYSIZE(unknownNodeIds)), 0);
+            CHECK_EQUAL(ed::DeleteLinks(nullptr, 0), 0);
+        }
+
+        if (ed::BeginDelete())
+        {
+            ++deleteFrames;
+
+            // Links of deleted nodes are deleted too.
+            deletedNodes = QueryIds(ed::QueryDeletedNodes);
+            deletedLinks = QueryIds(ed::QueryDeletedLinks);
+            ed::RejectDeletedItems();
+        }
+        ed::EndDelete();
+    });
+
+    CHECK_EQUAL(deleteFrames, 1);
+    CHECK(deletedNodes == IdList({ n0, n3 }));
+    CHECK(deletedLinks == IdList({ l0, l1, l2 }));
+}
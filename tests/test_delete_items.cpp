@@ -0,0 +1,190 @@
+# include "test.h"
+
+// AcceptDeletedItem() accepts only items returned by QueryDeleted*().
+TEST(DeleteItems_AcceptOnlyQueriedItem)
+{
+    EditorFixture fixture;
+    ChainGraph    graph(2);
+
+    int  deletedNodes = 0, deletedLinks = 0;
+    bool wasDeleting = false;
+    fixture.RunFrames(4, [&](int frame)
+    {
+        graph.Submit(frame == 0);
+
+        if (frame == 1)
+            ed::DeleteNode(graph.NodeAt(0));
+
+        if (ed::BeginDelete())
+        {
+            wasDeleting = true;
+
+            // Nothing was queried yet, there is no item to accept.
+            CHECK(!ed::AcceptDeletedItem());
+
+            ed::LinkId linkId;
+            while (ed::QueryDeletedLink(&linkId))
+            {
+                CHECK(ed::AcceptDeletedItem());
+                ++deletedLinks;
+
+                // Item is already accepted.
+                CHECK(!ed::AcceptDeletedItem());
+            }
+
+            ed::NodeId nodeId;
+            while (ed::QueryDeletedNode(&nodeId))
+            {
+                CHECK(ed::AcceptDeletedItem());
+                ++deletedNodes;
+            }
+
+            // All items were handled by loops above.
+            CHECK(!ed::AcceptDeletedItem());
+        }
+        ed::EndDelete();
+    });
+
+    CHECK(wasDeleting);
+    CHECK_EQUAL(deletedNodes, 1);
+    CHECK_EQUAL(deletedLinks, 1);
+}
+
+// Batch queries return pending items in chunks no larger than requested.
+// Accepted nodes are freed once application stops submitting them,
+// rejected ones stay.
+TEST(DeleteItems_QueryInBatches)
+{
+    const int c_NodeCount = 6;
+
+    auto config = EditorFixture::DefaultConfig();
+    config.DeadObjectLifetime = 2;
+
+    EditorFixture fixture(config);
+    ChainGraph    graph(c_NodeCount);
+
+    // Application side of the graph, deleted items are no longer submitted.
+    bool isNodeAlive[c_NodeCount];
+    bool isLinkAlive[c_NodeCount - 1];
+    for (auto& alive : isNodeAlive) alive = true;
+    for (auto& alive : isLinkAlive) alive = true;
+
+    auto submit = [&](bool place)
+    {
+        for (int i = 0; i < c_NodeCount; ++i)
+        {
+            if (!isNodeAlive[i])
+                continue;
+
+            if (place)
+                ed::SetNodePosition(graph.NodeAt(i), graph.PositionAt(i));
+
+            ed::BeginNode(graph.NodeAt(i));
+                ed::BeginPin(graph.InputAt(i), ed::PinKind::Input);
+                    ImGui::TextUnformatted("->");
+                ed::EndPin();
+                ImGui::SameLine();
+                ed::BeginPin(graph.OutputAt(i), ed::PinKind::Output);
+                    ImGui::TextUnformatted("->");
+                ed::EndPin();
+            ed::EndNode();
+        }
+
+        for (int i = 0; i < c_NodeCount - 1; ++i)
+            if (isLinkAlive[i])
+                ed::Link(graph.LinkAt(i), graph.OutputAt(i), graph.InputAt(i + 1));
+    };
+
+    ImVector<int> linkBatches;
+    ImVector<int> nodeBatches;
+    int  pendingLinks = -1, pendingNodes = -1;
+    int  deleteFrames = 0;
+    fixture.RunFrames(8, [&](int frame)
+    {
+        submit(frame == 0);
+
+        if (frame == 1)
+        {
+            ed::NodeId nodeIds[c_NodeCount];
+            for (int i = 0; i < c_NodeCount; ++i)
+                nodeIds[i] = graph.NodeAt(i);
+            CHECK_EQUAL(ed::DeleteNodes(nodeIds, c_NodeCount), c_NodeCount);
+        }
+
+        if (ed::BeginDelete())
+        {
+            ++deleteFrames;
+
+            // Every link touches a deleted node, so all of them are deleted too.
+            pendingLinks = ed::QueryDeletedLinks(nullptr, 0);
+            pendingNodes = ed::QueryDeletedNodes(nullptr, 0);
+
+            ed::LinkId linkIds[2];
+            while (int count = ed::QueryDeletedLinks(linkIds, IM_ARRAYSIZE(linkIds)))
+            {
+                linkBatches.push_back(count);
+                CHECK(ed::AcceptDeletedItems());
+                for (int i = 0; i < count; ++i)
+                    for (int j = 0; j < c_NodeCount - 1; ++j)
+                        if (linkIds[i] == graph.LinkAt(j))
+                            isLinkAlive[j] = false;
+            }
+
+            // First batch is accepted, the rest is rejected.
+            ed::NodeId nodeIds[4];
+            while (int count = ed::QueryDeletedNodes(nodeIds, IM_ARRAYSIZE(nodeIds)))
+            {
+                nodeBatches.push_back(count);
+                if (nodeBatches.Size > 1)
+                {
+                    ed::RejectDeletedItems();
+                    continue;
+                }
+
+                CHECK(ed::AcceptDeletedItems());
+                for (int i = 0; i < count; ++i)
+                    for (int j = 0; j < c_NodeCount; ++j)
+                        if (nodeIds[i] == graph.NodeAt(j))
+                            isNodeAlive[j] = false;
+            }
+
+            CHECK_EQUAL(ed::QueryDeletedLinks(nullptr, 0), 0);
+            CHECK_EQUAL(ed::QueryDeletedNodes(nullptr, 0), 0);
+        }
+        ed::EndDelete();
+    });
+
+    CHECK_EQUAL(deleteFrames, 1);
+    CHECK_EQUAL(pendingLinks, c_NodeCount - 1);
+    CHECK_EQUAL(pendingNodes, c_NodeCount);
+
+    CHECK_EQUAL(linkBatches.Size, 3);
+    if (linkBatches.Size == 3)
+    {
+        CHECK_EQUAL(linkBatches[0], 2);
+        CHECK_EQUAL(linkBatches[1], 2);
+        CHECK_EQUAL(linkBatches[2], 1);
+    }
+
+    CHECK_EQUAL(nodeBatches.Size, 2);
+    if (nodeBatches.Size == 2)
+    {
+        CHECK_EQUAL(nodeBatches[0], 4);
+        CHECK_EQUAL(nodeBatches[1], 2);
+    }
+
+    // Nodes are queried in order they were queued for deletion.
+    for (int i = 0; i < c_NodeCount; ++i)
+        CHECK(isNodeAlive[i] == (i >= 4));
+
+    fixture.RunFrames(1, [&](int)
+    {
+        submit(false);
+
+        for (int i = 0; i < c_NodeCount; ++i)
+        {
+            const bool isFreed = ed::GetNodePosition(graph.NodeAt(i)).x == FLT_MAX;
+            CHECK(isFreed == !isNodeAlive[i]);
+        }
+    });
+}
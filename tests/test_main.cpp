@@ -0,0 +1,61 @@
+# include "test.h"
+# include <cstdio>
+# include <cstring>
+
+static TestCase*  s_FirstTest  = nullptr;
+static TestCase** s_LastTest   = &s_FirstTest;
+static int        s_CheckFailures = 0;
+
+TestCase::TestCase(const char* name, void (*function)())
+    : m_Name(name)
+    , m_Function(function)
+    , m_Next(nullptr)
+{
+    // Tests run in order of registration.
+    *s_LastTest = this;
+    s_LastTest  = &m_Next;
+}
+
+void ReportCheckFailure(const char* file, int line, const char* expression)
+{
+    printf("%s(%d): check failed: %s\n", file, line, expression);
+    ++s_CheckFailures;
+}
+
+void ReportCheckFailure(const char* file, int line, const char* expression, long long actual, long long expected)
+{
+    printf("%s(%d): check failed: %s (%lld != %lld)\n", file, line, expression, actual, expected);
+    ++s_CheckFailures;
+}
+
+// Usage: node-editor-tests [filter], node-editor-benchmarks [filter]
+// Runs every test whose name contains 'filter'. Fails if any test failed or
+// if no test matched the filter.
+int main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : "";
+
+    int testCount   = 0;
+    int failedCount = 0;
+    for (auto test = s_FirstTest; test; test = test->m_Next)
+    {
+        if (!strstr(test->m_Name, filter))
+            continue;
+
+        printf("[ RUN    ] %s\n", test->m_Name);
+        fflush(stdout);
+
+        const auto checkFailures = s_CheckFailures;
+        test->m_Function();
+        const bool failed = s_CheckFailures != checkFailures;
+
+        printf("[ %s ] %s\n", failed ? "FAILED" : "    OK", test->m_Name);
+
+        ++testCount;
+        failedCount += failed ? 1 : 0;
+    }
+
+    printf("%d test(s) run, %d failed\n", testCount, failedCount);
+
+    return (failedCount != 0 || testCount == 0) ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+# include "test.h"
+# include <string.h>
+
+// Three nodes with a link between pins of the same node. One pin moves to
+// another node and one node disappears for a few frames.
+static void SubmitLinkedNodes(int frame, bool& isFirstNodeSubmitted)
+{
+    const bool movePin = frame >= 2;
+    isFirstNodeSubmitted = frame < 3 || frame >= 6;
+
+    auto pin = [](ed::PinId id, ed::PinKind kind)
+    {
+        ed::BeginPin(id, kind);
+            ImGui::TextUnformatted("->");
+        ed::EndPin();
+    };
+
+    if (frame == 0)
+    {
+        ed::SetNodePosition(1, ImVec2(0.0f, 0.0f));
+        ed::SetNodePosition(2, ImVec2(200.0f, 0.0f));
+        ed::SetNodePosition(3, ImVec2(400.0f, 0.0f));
+    }
+
+    if (isFirstNodeSubmitted)
+    {
+        ed::BeginNode(1);
+            pin(11, ed::PinKind::Output);
+            pin(12, ed::PinKind::Input);
+        ed::EndNode();
+    }
+
+    ed::BeginNode(2);
+        pin(21, ed::PinKind::Input);
+        if (!movePin)
+            pin(22, ed::PinKind::Output);
+    ed::EndNode();
+
+    ed::BeginNode(3);
+        pin(31, ed::PinKind::Input);
+        if (movePin)
+            pin(22, ed::PinKind::Output);
+    ed::EndNode();
+
+    ed::Link(101, 11, 21);
+    ed::Link(102, 22, 31);
+    ed::Link(103, 11, 12);
+}
+
+// Links listed for a node follow pins moved between nodes and survive
+// removal of a linked node.
+TEST(NodeLinks_FollowPins)
+{
+    EditorFixture fixture;
+
+    fixture.RunFrames(8, [&](int frame)
+    {
+        bool isFirstNodeSubmitted = false;
+        SubmitLinkedNodes(frame, isFirstNodeSubmitted);
+
+        const bool movePin = frame >= 2;
+
+        // Expected links, sorted by id.
+        ImVector<ed::LinkId> expected[3];
+        if (isFirstNodeSubmitted)
+        {
+            expected[0].push_back(101);
+            expected[0].push_back(103);
+            expected[1].push_back(101);
+        }
+        if (!movePin)
+            expected[1].push_back(102);
+        expected[2].push_back(102);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            ed::LinkId links[8];
+            const int count = ed::GetNodeLinks(i + 1, links, IM_ARRAYSIZE(links));
+            CHECK_EQUAL(count, expected[i].Size);
+            if (count == expected[i].Size && count > 0)
+                CHECK(memcmp(links, expected[i].Data, count * sizeof(ed::LinkId)) == 0);
+        }
+    });
+}
@@ -0,0 +1,48 @@
+# include "test.h"
+
+// Node is visible when only its pins are in view.
+TEST(NodeVisibility_PinInView)
+{
+    EditorFixture fixture;
+
+    const ed::NodeId nodeId = 1, farNodeId = 2;
+    const ed::PinId  pinId  = 3;
+
+    // Node is moved just past left edge of the view, its pin rect still
+    // sticks into the view.
+    bool isVisible = false, isFarVisible = true;
+    fixture.RunFrames(3, [&](int frame)
+    {
+        const auto viewMin = fixture.ViewMin();
+
+        if (frame == 0)
+        {
+            ed::SetNodePosition(nodeId, viewMin + ImVec2(200.0f, 200.0f));
+            ed::SetNodePosition(farNodeId, viewMin - ImVec2(5000.0f, 5000.0f));
+        }
+
+        if (frame == 2)
+        {
+            isVisible    = ed::IsNodeVisible(nodeId);
+            isFarVisible = ed::IsNodeVisible(farNodeId);
+        }
+
+        ed::BeginNode(nodeId);
+            ImGui::TextUnformatted("Node");
+            ed::BeginPin(pinId, ed::PinKind::Output);
+                ImGui::TextUnformatted("Out");
+                ed::PinRect(ImGui::GetItemRectMin(), ImGui::GetItemRectMax() + ImVec2(30.0f, 0.0f));
+            ed::EndPin();
+        ed::EndNode();
+
+        ed::BeginNode(farNodeId);
+            ImGui::TextUnformatted("Far");
+        ed::EndNode();
+
+        if (frame == 1)
+            ed::SetNodePosition(nodeId, ImVec2(viewMin.x - ed::GetNodeSize(nodeId).x - 5.0f, viewMin.y + 100.0f));
+    });
+
+    CHECK(isVisible);
+    CHECK(!isFarVisible);
+}
@@ -0,0 +1,107 @@
+# include "test.h"
+
+static const ImU32 c_BackgroundColor = IM_COL32(12, 34, 56, 255);
+
+// Node with versioned content and a button, background drawn after EndNode().
+// Returns true if button was clicked. Button center is updated only when
+// content is submitted.
+static bool SubmitRetainedNode(bool drawBackground, bool& isContentSubmitted, bool& isButtonHovered, ImVec2& buttonCenter)
+{
+    const ed::NodeId nodeId = 1;
+    const uint64_t   contentVersion = 1;
+
+    bool clicked = false;
+
+    isContentSubmitted = ed::BeginNode(nodeId, contentVersion);
+    isButtonHovered    = false;
+    if (isContentSubmitted)
+    {
+        ImGui::TextUnformatted("Retained");
+        clicked = ImGui::Button("Button");
+        isButtonHovered = ImGui::IsItemHovered();
+        buttonCenter = ed::CanvasToScreen((ImGui::GetItemRectMin() + ImGui::GetItemRectMax()) * 0.5f);
+    }
+    ed::EndNode();
+
+    if (drawBackground)
+    {
+        auto drawList = ed::GetNodeBackgroundDrawList(nodeId);
+        drawList->AddRectFilled(ed::GetNodePosition(nodeId), ed::GetNodePosition(nodeId) + ImVec2(40.0f, 10.0f), c_BackgroundColor);
+    }
+
+    return clicked;
+}
+
+static int CountVerticesWithColor(const ImDrawData* drawData, ImU32 color)
+{
+    ImVector<RenderedVertex> rendered;
+    RenderDrawData(drawData, rendered);
+
+    int count = 0;
+    for (auto& vertex : rendered)
+        if (vertex.Color == color)
+            ++count;
+    return count;
+}
+
+// Node replayed from retained content becomes live again when hovered and
+// its background is not drawn twice when user draws it again.
+TEST(RetainedContent_ReplayAndHover)
+{
+    EditorFixture fixture;
+
+    struct Step
+    {
+        const char* Name;
+        bool        MouseOverNode;
+        bool        MouseDown;
+        bool        DrawBackground;
+        bool        ExpectSubmitted;
+    };
+
+    const Step steps[] =
+    {
+        { "capture",                     false, false, true,  true  },
+        { "replay, background drawn",    false, false, true,  false },
+        { "replay, background retained", false, false, false, false },
+        { "hover",                       true,  false, true,  true  },
+        { "press",                       true,  true,  true,  true  },
+        { "release",                     true,  false, true,  true  },
+        { "capture after hover",         false, false, true,  true  },
+        { "replay after hover",          false, false, true,  false },
+    };
+
+    ImVec2 buttonCenter;
+    int    liveBackgroundVertices = -1;
+    bool   wasHovered = false, wasClicked = false;
+    for (auto& step : steps)
+    {
+        auto& io = ImGui::GetIO();
+        io.MousePos     = step.MouseOverNode ? buttonCenter : ImVec2(-FLT_MAX, -FLT_MAX);
+        io.MouseDown[0] = step.MouseDown;
+
+        bool isContentSubmitted = false, isButtonHovered = false, clicked = false;
+        fixture.RunFrames(1, [&](int)
+        {
+            clicked = SubmitRetainedNode(step.DrawBackground, isContentSubmitted, isButtonHovered, buttonCenter);
+        });
+
+        wasHovered |= isButtonHovered;
+        wasClicked |= clicked;
+
+        // Background drawn by live node is the reference.
+        const int backgroundVertices = CountVerticesWithColor(ImGui::GetDrawData(), c_BackgroundColor);
+        if (liveBackgroundVertices < 0)
+            liveBackgroundVertices = backgroundVertices;
+
+        if (isContentSubmitted != step.ExpectSubmitted || backgroundVertices != liveBackgroundVertices)
+            printf("  step '%s' failed\n", step.Name);
+
+        CHECK(isContentSubmitted == step.ExpectSubmitted);
+        CHECK_EQUAL(backgroundVertices, liveBackgroundVertices);
+    }
+
+    CHECK(liveBackgroundVertices > 0);
+    CHECK(wasHovered);
+    CHECK(wasClicked);
+}
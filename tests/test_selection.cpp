@@ -0,0 +1,87 @@
+# include "test.h"
+
+// Freeing selected object which is no longer submitted is reported by
+// HasSelectionChanged().
+TEST(Selection_DeadObjectIsReported)
+{
+    auto config = EditorFixture::DefaultConfig();
+    config.DeadObjectLifetime = 2;
+
+    EditorFixture fixture(config);
+    ChainGraph    graph(2);
+
+    // Selected node stops being submitted, it is freed a few frames later.
+    int changedFrames = 0, selectedCount = 0;
+    fixture.RunFrames(8, [&](int frame)
+    {
+        if (frame < 2)
+            graph.Submit(frame == 0);
+        if (frame == 1)
+            ed::SelectNode(graph.NodeAt(0));
+
+        if (frame >= 2 && ed::HasSelectionChanged())
+            ++changedFrames;
+        selectedCount = ed::GetSelectedObjectCount();
+    });
+
+    CHECK_EQUAL(changedFrames, 1);
+    CHECK_EQUAL(selectedCount, 0);
+}
+
+// Selection changes are reported for the frame they were made in.
+TEST(Selection_ChangesSinceBegin)
+{
+    EditorFixture fixture;
+    ChainGraph    graph(4);
+
+    const uintptr_t n0 = graph.NodeAt(0).Get(), n1 = graph.NodeAt(1).Get(), n2 = graph.NodeAt(2).Get();
+    const uintptr_t l0 = graph.LinkAt(0).Get(), l1 = graph.LinkAt(1).Get();
+
+    fixture.RunFrames(6, [&](int frame)
+    {
+        graph.Submit(frame == 0);
+
+        IdList addedNodes, removedNodes, addedLinks, removedLinks;
+        switch (frame)
+        {
+            case 1:
+                {
+                    const ed::NodeId nodeIds[] = { n0, n1 };
+                    ed::SelectNodes(nodeIds, IM_ARRAYSIZE(nodeIds));
+                    ed::SelectLink(l0, true);
+                }
+                addedNodes = { n0, n1 };
+                addedLinks = { l0 };
+                break;
+
+            case 3:
+                {
+                    // Node 1 stays selected, it is neither added nor removed.
+                    const ed::NodeId nodeIds[] = { n1, n2 };
+                    ed::SelectNodes(nodeIds, IM_ARRAYSIZE(nodeIds));
+                    ed::SelectLink(l1, true);
+                }
+                addedNodes   = { n2 };
+                removedNodes = { n0 };
+                addedLinks   = { l1 };
+                removedLinks = { l0 };
+                break;
+
+            case 4:
+                ed::ClearSelection();
+                removedNodes = { n1, n2 };
+                removedLinks = { l1 };
+                break;
+        }
+
+        const bool hasChanges = !addedNodes.empty() || !removedNodes.empty() || !addedLinks.empty() || !removedLinks.empty();
+        CHECK(ed::HasSelectionChanged() == hasChanges);
+
+        CHECK(QueryIds(ed::GetSelectionAddedNodes)   == addedNodes);
+        CHECK(QueryIds(ed::GetSelectionRemovedNodes) == removedNodes);
+        CHECK(QueryIds(ed::GetSelectionAddedLinks)   == addedLinks);
+        CHECK(QueryIds(ed::GetSelectionRemovedLinks) == removedLinks);
+    });
+
+    CHECK_EQUAL(ed::GetSelectedObjectCount(), 0);
+}
@@ -0,0 +1,106 @@
+# include "test.h"
+# include <math.h>
+
+// Group with two nodes inside, zoomed out far enough to show group hint.
+static void SubmitHintedGroup(int frame)
+{
+    const ed::NodeId groupId = 1, nodeAId = 2, nodeBId = 3;
+    const ed::PinId  outputId = 4, inputId = 5;
+    const ed::LinkId linkId = 6;
+
+    if (frame == 0)
+    {
+        ed::SetNodePosition(groupId, ImVec2(0.0f, 0.0f));
+        ed::SetNodePosition(nodeAId, ImVec2(200.0f, 200.0f));
+        ed::SetNodePosition(nodeBId, ImVec2(3200.0f, 1800.0f));
+    }
+
+    ed::BeginNode(groupId);
+        ImGui::TextUnformatted("Group");
+        ed::Group(ImVec2(4000.0f, 2400.0f));
+    ed::EndNode();
+
+    ed::BeginNode(nodeAId);
+        ImGui::TextUnformatted("Node A");
+        ed::BeginPin(outputId, ed::PinKind::Output);
+            ImGui::TextUnformatted("Out ->");
+        ed::EndPin();
+    ed::EndNode();
+
+    ed::BeginNode(nodeBId);
+        ImGui::TextUnformatted("Node B");
+        ed::BeginPin(inputId, ed::PinKind::Input);
+            ImGui::TextUnformatted("-> In");
+        ed::EndPin();
+    ed::EndNode();
+
+    ed::Link(linkId, outputId, inputId);
+
+    if (ed::BeginGroupHint(groupId))
+    {
+        auto min = ed::GetGroupMin();
+
+        ImGui::SetCursorScreenPos(min - ImVec2(-8.0f, ImGui::GetTextLineHeightWithSpacing() + 4.0f));
+        ImGui::TextUnformatted("Group Hint");
+
+        auto drawList = ed::GetHintBackgroundDrawList();
+        drawList->AddRectFilled(ImGui::GetItemRectMin() - ImVec2(8.0f, 4.0f), ImGui::GetItemRectMax() + ImVec2(8.0f, 4.0f), IM_COL32(255, 255, 255, 64), 4.0f);
+
+        drawList = ed::GetHintForegroundDrawList();
+        drawList->AddRect(min, ed::GetGroupMax(), IM_COL32(255, 255, 0, 255));
+    }
+    ed::EndGroupHint();
+
+    if (frame == 1)
+        ed::NavigateToContent(0.001f);
+}
+
+// Editor drawn with canvas transform applied by renderer looks the same as
+// with vertices transformed on CPU, group hints included.
+TEST(TransformCallback_MatchesCpuTransform)
+{
+    const int c_Frames = 5;
+
+    ImVector<RenderedVertex> rendered[2];
+    float zoom[2] = { 0.0f, 0.0f };
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        auto config = EditorFixture::DefaultConfig();
+        config.CanvasTransformCallback = mode ? EmulatedTransformCallback : nullptr;
+
+        EditorFixture fixture(config);
+        fixture.RunFrames(c_Frames, [&](int frame)
+        {
+            SubmitHintedGroup(frame);
+            zoom[mode] = ed::GetCurrentZoom();
+        });
+
+        RenderDrawData(ImGui::GetDrawData(), rendered[mode]);
+    }
+
+    // Group hint is shown only when zoomed out.
+    CHECK(zoom[0] > 1.0f);
+    CHECK(zoom[0] == zoom[1]);
+
+    auto& cpu = rendered[0];
+    auto& gpu = rendered[1];
+
+    auto isClose = [](float lhs, float rhs) { return fabsf(lhs - rhs) <= 0.01f; };
+
+    CHECK(cpu.Size > 0);
+    CHECK_EQUAL(gpu.Size, cpu.Size);
+
+    int mismatches = 0;
+    for (int i = 0; i < cpu.Size && i < gpu.Size; ++i)
+    {
+        auto& a = cpu[i];
+        auto& b = gpu[i];
+        if (!isClose(a.Position.x, b.Position.x) || !isClose(a.Position.y, b.Position.y) ||
+            a.UV.x != b.UV.x || a.UV.y != b.UV.y || a.Color != b.Color ||
+            !isClose(a.ClipRect.x, b.ClipRect.x) || !isClose(a.ClipRect.y, b.ClipRect.y) ||
+            !isClose(a.ClipRect.z, b.ClipRect.z) || !isClose(a.ClipRect.w, b.ClipRect.w))
+            ++mismatches;
+    }
+
+    CHECK_EQUAL(mismatches, 0);
+}